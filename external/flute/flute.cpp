@@ -37,6 +37,7 @@
 #include <math.h>
 #include <string>
 #include <algorithm>
+#include <mutex>
 #include "flute.h"
 
 namespace Flute {
@@ -210,7 +211,10 @@ checkLUT(LUT_TYPE LUT1,
 extern std::string post9;
 extern std::string powv9;
 
-void readLUT() {
+// The LUTs are only written once, flute() can then be called concurrently.
+static std::once_flag read_lut_flag;
+
+static void readLUTOnce() {
   makeLUT(LUT, numsoln);
 
 #if LUT_SOURCE==LUT_FILE
@@ -218,6 +222,8 @@ void readLUT() {
 
 #elif LUT_SOURCE==LUT_VAR
   initLUT(LUT, numsoln);
+  // Load the degree 8 and 9 tables eagerly instead of on the first query.
+  readLUT9(LUT, numsoln, FLUTE_D);
 
 #elif LUT_SOURCE==LUT_VAR_CHECK
   readLUTfiles(LUT, numsoln);
@@ -230,6 +236,10 @@ void readLUT() {
 #endif
 }
 
+void readLUT() {
+  std::call_once(read_lut_flag, readLUTOnce);
+}
+
 static void
 makeLUT(LUT_TYPE &LUT,
 	NUMSOLN_TYPE &numsoln)
@@ -31,31 +31,42 @@
 #pragma once
 
 #include "OpenPhySyn/Database/Types.hpp"
+#include "OpenPhySyn/Liberty/ArcTable.hpp"
+#include "OpenPhySyn/Liberty/CharacterizationCache.hpp"
+#include "OpenPhySyn/Liberty/CompiledFunction.hpp"
+#include "OpenPhySyn/Sta/NegativeSlackPathIterator.hpp"
+#include "OpenPhySyn/Sta/PathArena.hpp"
 #include "OpenPhySyn/Sta/PathPoint.hpp"
+#include "OpenPhySyn/Utils/DenseTable.hpp"
 
+#include <atomic>
 #include <bitset>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 namespace sta
 {
 class TimingArc;
+class TableModel;
 class RiseFall;
 class ParasiticAnalysisPt;
 class Pvt;
 class Corner;
 class Path;
+class PathRef;
 class Vertex;
 class FuncExpr;
 class MinMax;
 class PathEnd;
-class ParasiticNode;
 class DcalcAnalysisPt;
 class Parasitic;
+class ArcDelayCalc;
 } // namespace sta
 
 namespace psn
@@ -79,6 +90,18 @@ enum ElectircalViolation
     CapacitanceAndTransition
 };
 
+// Estimated timing of an instance resized to a library cell
+struct SizingCandidate
+{
+    LibraryCell* cell;
+    float        delay;       // Worst delay to the output pins
+    float        slew;        // Worst output slew
+    float        fanin_delay; // Worst delay added to the fanin drivers
+    float        slack;       // Worst slack at the output pins
+    float        area;
+    bool         legal; // Within the output slew and capacitance limits
+};
+
 class DatabaseHandler
 {
 
@@ -96,8 +119,8 @@ public:
                                           bool include_top_level = false) const;
     std::vector<Instance*>     fanoutInstances(Net* net) const;
     std::vector<InstanceTerm*>
-                               levelDriverPins(bool                              reverse = false,
-                                               std::unordered_set<InstanceTerm*> filter_pins =
+                               levelDriverPins(bool                                     reverse = false,
+                                               const std::unordered_set<InstanceTerm*>& filter_pins =
                                                    std::unordered_set<InstanceTerm*>()) const;
     std::vector<Instance*>     driverInstances() const;
     InstanceTerm*              faninPin(Net* net) const;
@@ -109,7 +132,29 @@ public:
     Net*                       net(Term* term) const;
     std::vector<InstanceTerm*> connectedPins(Net* net) const;
     std::set<InstanceTerm*>    clockPins() const;
+    // Overloads filling a caller-provided container, cleared first, so the
+    // hot loops can reuse its storage instead of allocating on every call
+    void inputPins(Instance* inst, std::vector<InstanceTerm*>& terms,
+                   bool include_top_level = false) const;
+    void outputPins(Instance* inst, std::vector<InstanceTerm*>& terms,
+                    bool include_top_level = false) const;
+    void fanoutPins(Net* net, std::vector<InstanceTerm*>& terms,
+                    bool include_top_level = false) const;
+    void pins(Net* net, std::vector<InstanceTerm*>& terms) const;
+    void pins(Instance* inst, std::vector<InstanceTerm*>& terms) const;
+    void connectedPins(Net* net, std::vector<InstanceTerm*>& terms) const;
+    void libraryPins(LibraryCell* cell, std::vector<LibraryTerm*>& terms) const;
+    void libraryInputPins(LibraryCell*               cell,
+                          std::vector<LibraryTerm*>& terms) const;
+    void libraryOutputPins(LibraryCell*               cell,
+                           std::vector<LibraryTerm*>& terms) const;
     std::set<Net*>             clockNets() const;
+    // Dense object IDs, stable while the object exists, for DenseTable and
+    // DenseSet lookups
+    size_t                     id(InstanceTerm* term) const;
+    size_t                     id(Net* net) const;
+    size_t                     id(Instance* inst) const;
+    size_t                     id(LibraryCell* cell);
     Point                      location(InstanceTerm* term);
     Point                      location(Instance* inst);
     float                      area(LibraryCell* cell) const;
@@ -145,6 +190,11 @@ public:
     float pinAverageFallTransition(LibraryTerm* from, LibraryTerm* to) const;
     float loadCapacitance(InstanceTerm* term) const;
     std::vector<std::vector<PathPoint>> getNegativeSlackPaths() const;
+    void getNegativeSlackPaths(PathArena& paths) const;
+    // Negative slack paths ordered from the worst endpoint and expanded on
+    // demand, limited to max_paths paths of max_depth points when set
+    NegativeSlackPathIterator negativeSlackPaths(size_t max_paths = 0,
+                                                 size_t max_depth = 0) const;
     float                               maxLoad(LibraryCell* cell);
     float       capacitanceLimit(InstanceTerm* term) const;
     float       targetLoad(LibraryCell* cell);
@@ -169,7 +219,14 @@ public:
                     float* tr_slew = nullptr);
     float gateDelay(LibraryTerm* out_port, float load_cap,
                     float* tr_slew = nullptr);
+    // Worst delay and output slew of the output port driving each of the
+    // count load capacitances, slews can be null
+    void gateDelays(LibraryTerm* out_port, const float* load_caps,
+                    float* delays, float* slews, size_t count,
+                    float* tr_slew = nullptr);
     float bufferChainDelayPenalty(float load_cap);
+    // Worst interpolation error of the buffer chain penalty curve
+    float bufferChainDelayPenaltyError() const;
     float inverterInputCapacitance(LibraryCell* buffer_cell);
     float bufferInputCapacitance(LibraryCell* buffer_cell) const;
     float bufferOutputCapacitance(LibraryCell* buffer_cell);
@@ -179,6 +236,8 @@ public:
     float         largestInputCapacitance(LibraryCell* cell);
     float portCapacitance(const LibraryTerm* port, bool isMax = true) const;
     float bufferDelay(psn::LibraryCell* buffer_cell, float load_cap);
+    void  bufferDelays(psn::LibraryCell* buffer_cell, const float* load_caps,
+                       float* delays, size_t count);
     float maxLoad(LibraryTerm* term);
     Net*  net(const char* name) const;
     LibraryTerm* libraryPin(const char* cell_name, const char* pin_name) const;
@@ -226,10 +285,21 @@ public:
                               bufferClusters(float cluster_threshold, bool find_superior = true,
                                              bool include_inverting = true);
     std::vector<LibraryCell*> equivalentCells(LibraryCell* cell);
+    // What-if sizing: the instance timing with each of the cells is estimated
+    // from the current slews, arrivals and parasitics without editing the
+    // netlist. The legal candidates come first, then by slack and area.
+    std::vector<SizingCandidate>
+    evaluateSizes(Instance* inst, const std::vector<LibraryCell*>& cells);
     LibraryCell*              smallestInverterCell() const;
     LibraryCell*              smallestBufferCell() const;
     bool                      isClocked(InstanceTerm* term) const;
+    // Clock network classification, computed once from STA and kept in sync
+    // with the nets created and deleted through the handler
     bool                      isClock(Net* net) const;
+    void                      invalidateClockNets();
+    // Drop the driver pin index used by levelDriverPins(), it is rebuilt on
+    // the next call
+    void                      invalidateDriverIndex();
     bool                      isPrimary(Net* net) const;
     bool                      isInput(InstanceTerm* term) const;
     bool                      isOutput(InstanceTerm* term) const;
@@ -298,6 +368,10 @@ public:
     std::vector<PathPoint>              criticalPath(int path_count = 1) const;
     std::vector<std::vector<PathPoint>> criticalPaths(int path_count = 1) const;
     std::vector<std::vector<PathPoint>> bestPath(int path_count = 1) const;
+    // Same as the vector versions with all the paths stored in one arena,
+    // the arena is cleared first
+    void criticalPaths(PathArena& paths, int path_count = 1) const;
+    void bestPath(PathArena& paths, int path_count = 1) const;
     std::vector<PathPoint>              worstSlackPath(InstanceTerm* term,
                                                        bool          trim = false) const;
     InstanceTerm*                       worstSlackPin() const;
@@ -318,6 +392,12 @@ public:
                    PathAnalysisPoint* path_ap) const;
     bool  isCommutative(InstanceTerm* first, InstanceTerm* second) const;
     bool  isCommutative(LibraryTerm* first, LibraryTerm* second) const;
+    // Group the input pins of the library cells into commutative classes,
+    // cells of libraries loaded later are classified on their first query
+    void  findCommutativeClasses(Liberty* lib);
+    // Compile the timing arcs of the library ports for the lock-free lookups
+    // of the delay estimates, the tables live until resetCache()
+    void  compileArcs(Liberty* lib);
     bool  isBuffer(LibraryCell* cell) const;
     bool  isInverter(LibraryCell* cell) const;
     bool  dontUse(LibraryCell* cell) const;
@@ -370,6 +450,28 @@ public:
     HandlerType handlerType() const;
     void        calculateParasitics();
     void        calculateParasitics(Net* net);
+    void        flushParasitics() const;
+    // Timing edit transaction, the edits made between beginTimingEdit() and
+    // endTimingEdit() record the pins they touch and the timing of these
+    // pins is invalidated once, by the next timing query
+    void        beginTimingEdit();
+    void        endTimingEdit();
+    // Update the timing needed by the pin slack: the delays and arrivals are
+    // propagated from the invalidated pins and stop where the values do not
+    // change, the requireds are propagated back to the level of the pin
+    void        updateTiming(InstanceTerm* term) const;
+    // Netlist checkpoints, the edits made through the handler after
+    // checkpoint() are journaled with the parasitics they replace, rollback()
+    // undoes them in reverse order and commit() keeps them. Checkpoints can
+    // be nested and also open a timing edit transaction.
+    void        checkpoint();
+    void        rollback();
+    void        commit();
+    void        setParasiticsThreads(int thread_count);
+    int         parasiticsThreads() const;
+    // Keep the library characterization tables in a cache file of the
+    // directory, an empty path disables the cache
+    bool        setCharacterizationCache(const std::string& directory);
     void        resetCache();
     void        setLegalizer(Legalizer legalizer);
     bool        legalize(int max_displacement = 0);
@@ -377,11 +479,17 @@ public:
 
     DatabaseStaNetwork* network() const;
     DatabaseSta*        sta() const;
+    // Free the delay calculators copied for the threads that queried delays
+    // concurrently, should be called once the parallel region is over
+    void releaseThreadDelayCalculators();
     ~DatabaseHandler();
 
     int evaluateFunctionExpression(
         sta::FuncExpr*                         func,
         std::unordered_map<LibraryTerm*, int>& inputs) const;
+    // Function of the output pin compiled over the cell input pins, in the
+    // order of libraryInputPins()
+    const CompiledFunction& compiledFunction(LibraryTerm* term) const;
     Vertex* vertex(InstanceTerm* term) const;
 
 private:
@@ -404,6 +512,74 @@ private:
     std::vector<LibraryCell*> buffer_inverter_seq_;
     float                     maximum_area_;
     bool                      maximum_area_valid_;
+    int                       parasitics_threads_;
+
+    mutable std::unordered_set<Net*> dirty_nets_; // Edited nets waiting for
+                                                  // their parasitics update
+
+    int timing_edit_depth_; // Nesting of the open timing edit transactions
+    mutable std::unordered_set<InstanceTerm*>
+        timing_edit_pins_; // Pins waiting for their timing invalidation
+
+    enum class JournalOp
+    {
+        Connect,
+        Disconnect,
+        CreateInstance,
+        DeleteInstance,
+        CreateNet,
+        DeleteNet,
+        ReplaceCell,
+        Move,
+        MarkParasitics,
+        Parasitics
+    };
+    // Pins are journaled by instance and port since undoing an instance
+    // deletion creates a new instance
+    struct JournalPin
+    {
+        Instance* inst;
+        Port*     port;
+    };
+    // Pi-elmore model of a driver pin for one transition
+    struct JournalParasitic
+    {
+        JournalPin                                driver;
+        int                                       rf_index;
+        bool                                      exists;
+        float                                     c2, rpi, c1;
+        std::vector<std::pair<JournalPin, float>> elmore; // Load delays
+    };
+    struct JournalEntry
+    {
+        JournalOp                     op;
+        JournalPin                    pin;
+        Instance*                     inst;
+        Net*                          net;
+        LibraryCell*                  cell;     // Previous master
+        std::string                   name;     // Deleted object name
+        int                           x, y;     // Previous origin
+        int                           orient;   // Deleted orientation
+        bool                          flag;     // Placed or clock net
+        std::vector<JournalParasitic> parasitics;
+    };
+    mutable std::vector<JournalEntry> journal_;
+    std::vector<size_t> checkpoints_; // Journal size at each checkpoint
+    mutable std::vector<std::unordered_set<Net*>>
+        journaled_nets_; // Nets with saved parasitics at each checkpoint
+    mutable bool        rolling_back_;
+
+    mutable std::mutex        clock_nets_mutex_; // Guards the table edits
+    mutable std::atomic<bool> clock_nets_valid_; // Clock net table is built
+    mutable DenseTable<char>  clock_nets_;       // Clock flag by net ID
+
+    // Driver pins indexed by pin ID and their order by level then pin ID, the
+    // order is refreshed after the connectivity changes
+    mutable bool                       driver_index_valid_;
+    mutable bool                       driver_order_valid_;
+    mutable std::vector<InstanceTerm*> driver_index_; // Null for non-drivers
+    mutable std::vector<InstanceTerm*> driver_order_;
+    mutable std::vector<size_t>        level_counts_; // Level bucket offsets
 
     std::unordered_set<LibraryCell*> nand_cells_;
     std::unordered_set<LibraryCell*> and_cells_;
@@ -414,14 +590,19 @@ private:
 
     std::unordered_set<LibraryCell*> dont_use_;
 
-    std::unordered_map<LibraryCell*, float> buffer_penalty_map_;
-    std::unordered_map<LibraryCell*, float> inverting_buffer_penalty_map_;
-    std::unordered_set<LibraryCell*>        non_inverting_buffer_;
-    std::unordered_set<LibraryCell*>        inverting_buffer_;
-    std::unordered_map<LibraryTerm*, std::unordered_set<LibraryTerm*>>
-        commutative_pins_cache_;
-
-    std::unordered_map<float, float> penalty_cache_;
+    DenseTable<float>                buffer_penalty_map_;
+    DenseTable<float>                inverting_buffer_penalty_map_;
+    std::unordered_set<LibraryCell*> non_inverting_buffer_;
+    std::unordered_set<LibraryCell*> inverting_buffer_;
+    mutable std::unordered_map<LibraryTerm*, int>
+                commutative_classes_; // Commutative pins of a cell share a
+                                      // class, -1 for the other pins
+    mutable int commutative_class_count_;
+
+    std::vector<float> penalty_curve_;       // Buffer chain penalty samples
+    float              penalty_curve_start_; // Load of the first sample
+    float              penalty_curve_step_;  // Load step between samples
+    float              penalty_curve_error_; // Worst interpolation error
     std::unordered_map<std::string, std::shared_ptr<LibraryCellMapping>>
                                                   library_cell_mappings_;
     std::unordered_map<LibraryCell*, std::string> truth_tables_;
@@ -434,11 +615,62 @@ private:
 
     int computeTruthTable(LibraryCell* cell);
 
-    std::unordered_map<LibraryCell*, float> target_load_map_;
+    DenseTable<float> target_load_map_;
+
+    // Characterization cache directory, empty if the cache is disabled, and
+    // the cache file of the current libraries
+    std::string           characterization_dir_;
+    std::string           characterization_path_;
+    bool                  characterization_key_valid_;
+    std::vector<Liberty*> characterization_libs_; // Libraries of the key
+    std::string           characterization_conditions_; // Corner and PVT
+    CharacterizationCache characterization_cache_;
+    std::mutex            characterization_mutex_; // Guards the cache key
+
+    std::mutex cell_ids_mutex_; // Guards unmapped_cell_ids_
+    std::unordered_map<LibraryCell*, size_t>
+        unmapped_cell_ids_; // IDs of the cells without a physical master
 
     // Vertex* vertex(InstanceTerm* term) const;
 
+    void findClockNets() const;
+    void findCommutativeClasses(LibraryCell* cell) const;
+    int  commutativeClass(LibraryTerm* term) const;
+    void indexDriverPins() const;
+    void indexDriverPins(Instance* inst, bool is_removed) const;
+    void sortDriverPins() const;
+    // Keep the pins matching the direction, in place
+    void retainPins(std::vector<InstanceTerm*>& terms,
+                    PinDirection*               direction) const;
+    // Number of input or output ports of the cell and the first of them,
+    // counted without collecting the ports
+    int libraryPinCount(LibraryCell* cell, bool output,
+                        LibraryTerm** first = nullptr) const;
+    void setClock(Net* net, bool is_clock) const;
+    // Drop the side table entries keyed by the IDs of a deleted object, the
+    // database hands the freed IDs to the objects created later
+    void eraseIds(Net* net) const;
+    void eraseIds(Instance* inst) const;
+    // Invalidate the timing of the pin, deferred inside a transaction
+    void touchTiming(InstanceTerm* term);
+    void flushTimingEdits() const;
+    bool journaling() const;
+    void journal(JournalOp op, InstanceTerm* term, Net* net) const;
+    void journalParasitics(Net* net) const;
+    // Save the net parasitics once per checkpoint
+    void journalNet(Net* net) const;
+    void restoreParasitics(
+        const JournalEntry&                                    entry,
+        const std::function<InstanceTerm*(const JournalPin&)>& resolve);
+    void replaceCell(Instance* inst, LibraryCell* cell);
+
     void computeBuffersDelayPenalty(bool include_inverting = true);
+    bool loadBuffersDelayPenalty(bool include_inverting);
+    void computeBuffersDelayPenaltyCurve();
+    // Exact buffer chain penalty of each load above the smallest buffer input
+    // capacitance
+    void bufferChainDelayPenalties(const std::vector<float>& load_caps,
+                                   std::vector<float>&       penalties);
 
     /* The following code is borrowed from James Cherry's Resizer Code */
     const sta::Corner*              corner_;
@@ -446,6 +678,35 @@ private:
     const sta::Pvt*                 pvt_;
     const sta::ParasiticAnalysisPt* parasitics_ap_;
     float                           target_slews_[2];
+
+    std::thread::id    main_thread_; // Thread using the STA delay calculator
+    mutable std::mutex delay_calc_mutex_; // Guards thread_delay_calcs_
+    std::mutex         penalty_mutex_;    // Guards the lazy penalty cache
+    mutable std::unordered_map<std::thread::id, sta::ArcDelayCalc*>
+        thread_delay_calcs_;         // Delay calculators of the worker threads
+    std::unordered_map<LibraryTerm*, size_t>
+        library_term_ids_; // Dense IDs of the ports with compiled arcs
+    std::vector<CompiledArcs>
+        compiled_arcs_; // Timing arcs driving each port, indexed by its ID
+    std::mutex compiled_arcs_mutex_; // Guards extra_compiled_arcs_
+    std::unordered_map<LibraryTerm*, std::unique_ptr<CompiledArcs>>
+        extra_compiled_arcs_; // Ports of libraries loaded outside readLib()
+    mutable std::mutex compiled_functions_mutex_; // Guards
+                                                  // compiled_functions_
+    mutable std::unordered_map<LibraryTerm*, std::unique_ptr<CompiledFunction>>
+        compiled_functions_; // Compiled function of each output pin
+    void compileFunction(sta::FuncExpr*    func,
+                         CompiledFunction& compiled) const;
+    // Timing arcs driving the output port with their flattened tables
+    const CompiledArcs& compiledArcs(LibraryTerm* out_port);
+    void compileArcs(LibraryTerm* out_port, CompiledArcs& arcs) const;
+    bool compileTable(LibraryCell* cell, const sta::TableModel* model,
+                      ArcTable& table) const;
+    // Delay and output slew of a compiled arc
+    void arcDelay(LibraryCell* cell, const CompiledArc& arc, float in_slew,
+                  float load_cap, float& delay, float& slew);
+    // Delay calculator owned by the calling thread
+    sta::ArcDelayCalc* arcDelayCalc() const;
     float pinTableAverage(LibraryTerm* from, LibraryTerm* to,
                           bool is_delay = true, bool is_rise = true) const;
     float pinTableLookup(LibraryTerm* from, LibraryTerm* to, float slew,
@@ -453,13 +714,29 @@ private:
                          bool is_rise = true) const;
     std::vector<std::vector<PathPoint>> getPaths(bool get_max,
                                                  int  path_count = 1) const;
+    void getPaths(bool get_max, int path_count, PathArena& paths) const;
     std::vector<PathPoint>              expandPath(sta::PathEnd* path_end,
                                                    bool          enumed = false) const;
     std::vector<PathPoint>              expandPath(sta::Path* path,
                                                    bool       enumed = false) const;
+    // Append the expanded path to the arena
+    void      expandPath(sta::Path* path, PathArena& paths,
+                         bool enumed = false) const;
+    PathPoint pathPoint(const sta::PathRef* ref, bool enumed) const;
     void                                findTargetLoads();
+    bool                                loadTargetLoads();
     void                                makeEquivalentCells();
 
+    // Characterization cache of the loaded libraries and don't-use cells,
+    // null if the cache is disabled
+    CharacterizationCache* characterizationCache();
+    void                   saveCharacterizationCache();
+    // Cell names are qualified by the library name
+    std::string  characterizationName(LibraryCell* cell) const;
+    LibraryCell* characterizationCell(const std::string& name) const;
+    bool         characterizationCells(const std::vector<std::string>& names,
+                                       std::vector<LibraryCell*>& cells) const;
+
     void  findTargetLoads(std::vector<Liberty*>* resize_libs);
     void  findTargetLoads(Liberty* library, float slews[]);
     void  findTargetLoad(LibraryCell* cell, float slews[]);
@@ -470,11 +747,9 @@ private:
     void  findBufferTargetSlews(Liberty* library, float slews[], int counts[]);
     void  slewLimit(InstanceTerm* pin, sta::MinMax* min_max, float& limit,
                     bool& exists) const;
-    sta::ParasiticNode* findParasiticNode(std::unique_ptr<SteinerTree>& tree,
-                                          sta::Parasitic*     parasitic,
-                                          const Net*          net,
-                                          const InstanceTerm* pin,
-                                          SteinerPoint        pt);
+    void computeParasitics(Net* net) const;
+    void annotateParasitics(Net*                          net,
+                            std::unique_ptr<SteinerTree>& tree) const;
     Legalizer           legalizer_;
     ParasticsCallback   res_per_micron_callback_;
     ParasticsCallback   cap_per_micron_callback_;
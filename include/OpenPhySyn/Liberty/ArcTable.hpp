@@ -0,0 +1,92 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace sta
+{
+class TimingArc;
+} // namespace sta
+
+namespace psn
+{
+
+// ArcTable is a flattened NLDM table indexed by the input slew and the load
+// capacitance, the values are stored slew-major and already include the
+// library scaling factors. Missing axes hold a single zero entry.
+class ArcTable
+{
+public:
+    ArcTable();
+    ArcTable(std::vector<float> slews, std::vector<float> caps,
+             std::vector<float> values);
+
+    // Bilinear interpolation, extrapolating linearly outside the axes
+    float findValue(float in_slew, float load_cap) const;
+
+    // Evaluate the same input slew against count load capacitances, the slew
+    // rows are blended once for the whole batch
+    void findValues(float in_slew, const float* load_caps, float* values,
+                    size_t count) const;
+
+    const std::vector<float>& slews() const;
+    const std::vector<float>& capacitances() const;
+    const std::vector<float>& values() const;
+
+private:
+    std::vector<float> slews_;  // Input slew axis
+    std::vector<float> caps_;   // Load capacitance axis
+    std::vector<float> values_; // slews_.size() x caps_.size() values
+
+    static size_t axisIndex(const std::vector<float>& axis, float value);
+};
+
+// CompiledArc is a timing arc driving an output port. The delay and slew
+// tables are filled when the arc model is a table over the input slew and
+// the load capacitance, otherwise the delay calculator is used.
+class CompiledArc
+{
+public:
+    CompiledArc(sta::TimingArc* arc, int in_rise_fall, int out_rise_fall);
+
+    sta::TimingArc* arc;      // Source arc
+    int             in_rf;    // Input transition index
+    int             out_rf;   // Output transition index
+    bool            compiled; // Tables are valid
+    ArcTable        delay;    // Delay table
+    ArcTable        slew;     // Output slew table
+};
+
+typedef std::vector<CompiledArc> CompiledArcs;
+
+} // namespace psn
@@ -0,0 +1,105 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace psn
+{
+
+// CharacterizationCache keeps the library characterization tables, e.g. the
+// target loads and the buffer delay penalties, in a binary file keyed by a
+// hash of the library contents. Each record holds a list of cell names and a
+// list of values. The cache file is memory-mapped and its records are decoded
+// on lookup, the new records are written back by save().
+class CharacterizationCache
+{
+public:
+    // Files with another version are ignored
+    static const uint32_t version = 1;
+
+    CharacterizationCache();
+    ~CharacterizationCache();
+    CharacterizationCache(const CharacterizationCache&) = delete;
+    CharacterizationCache& operator=(const CharacterizationCache&) = delete;
+
+    // 64-bit FNV-1a hash
+    static uint64_t hashBytes(const void* data, size_t size,
+                              uint64_t seed = 14695981039346656037ULL);
+    static uint64_t hash(const std::string& str,
+                         uint64_t           seed = 14695981039346656037ULL);
+    // Hash of the file contents, returns false if the file cannot be read
+    static bool hashFile(const std::string& path, uint64_t& seed);
+
+    // Drop all records and start an empty cache for the key
+    void reset(uint64_t key);
+    // Map the cache file, returns false and keeps an empty cache if the file
+    // is missing, corrupted or has another version or key
+    bool load(const std::string& path, uint64_t key);
+    // Write all the records to the file, the file is replaced atomically so
+    // concurrent sessions never read a partial cache
+    bool save(const std::string& path) const;
+
+    uint64_t key() const;
+    size_t   size() const;
+    // There are records that are not in the loaded file
+    bool modified() const;
+
+    bool find(const std::string& name, std::vector<std::string>& cells,
+              std::vector<float>& values) const;
+    void insert(const std::string& name, const std::vector<std::string>& cells,
+                const std::vector<float>& values);
+
+private:
+    typedef std::pair<const char*, size_t> Payload;
+
+    uint64_t key_;
+    void*    map_;      // Mapped cache file
+    size_t   map_size_; // Size of the mapping
+    std::string
+        file_data_; // File contents when the file could not be mapped
+    std::unordered_map<std::string, Payload>
+        loaded_; // Payloads of the loaded records
+    std::unordered_map<std::string, std::string>
+                       inserted_; // Payloads of the new records
+    mutable std::mutex mutex_;    // Guards the records
+
+    void unmap();
+    bool parse(const char* data, size_t size, uint64_t key);
+};
+
+} // namespace psn
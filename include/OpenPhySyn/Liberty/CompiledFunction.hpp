@@ -0,0 +1,106 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "OpenPhySyn/Database/Types.hpp"
+
+namespace psn
+{
+
+// CompiledFunction is a Boolean function of a library cell compiled to
+// postfix code over the indices of the cell input pins. Every instruction
+// works on 64-bit words, so one run evaluates 64 minterms of the truth
+// table, or a single input assignment when the inputs are all-zero or
+// all-one words.
+class CompiledFunction
+{
+public:
+    enum Operation : unsigned char
+    {
+        Input,
+        One,
+        Zero,
+        Not,
+        And,
+        Or,
+        Xor
+    };
+
+    // Functions of up to 64 inputs can be compiled
+    static const size_t max_inputs = 64;
+    // Truth tables are limited to 2^20 minterms
+    static const size_t max_table_inputs = 20;
+
+    CompiledFunction(std::vector<LibraryTerm*> inputs =
+                         std::vector<LibraryTerm*>());
+
+    // Code building in postfix order
+    void pushInput(int index);
+    void pushConstant(bool value);
+    void pushOperation(Operation op);
+    // Mark the function as not compilable, e.g. it reads a non-input pin
+    void invalidate();
+
+    bool                             valid() const;
+    const std::vector<LibraryTerm*>& inputs() const;
+    // Index of the input pin, -1 if the pin is not an input
+    int inputIndex(LibraryTerm* term) const;
+    // Mask of the inputs read by the function
+    uint64_t usedInputs() const;
+
+    // Output for the input values given by the bits of input_bits, -1 if the
+    // function is not valid
+    int evaluate(uint64_t input_bits) const;
+    // Bit m of word m / 64 is the output for the input values given by the
+    // bits of m. Returns false for invalid functions or too many inputs.
+    bool truthTable(std::vector<uint64_t>& table) const;
+
+private:
+    struct Instruction
+    {
+        Operation op;
+        int       input;
+    };
+
+    std::vector<LibraryTerm*> inputs_;      // Input pins by index
+    std::vector<Instruction>  code_;        // Postfix code
+    uint64_t                  used_inputs_; // Inputs read by the code
+    int                       depth_;       // Stack depth after the code
+    int                       max_depth_;   // Largest stack depth
+    bool                      valid_;       // Code can be run
+
+    uint64_t run(const uint64_t* input_words) const;
+};
+
+} // namespace psn
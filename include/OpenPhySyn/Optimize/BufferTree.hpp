@@ -38,12 +38,23 @@
 #include "opendb/geom.h"
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace psn
 {
 
 class Psn;
 
+// Timing of a net sink captured serially before the buffer candidates are
+// built concurrently, the workers do not query the timer
+struct SinkTiming
+{
+    float capacitance;
+    float required;
+};
+typedef std::unordered_map<InstanceTerm*, SinkTiming> SinkTimingSnapshot;
+
 enum BufferMode
 {
     TimingDriven,
@@ -80,7 +91,8 @@ class BufferTree
     float                       wire_delay_or_slew_;   // Wire delay
     float                       cost_;                 // Tree cost
     Point                       location_;             // Buffer location
-    std::shared_ptr<BufferTree> left_, right_;         // Left and right nodes
+    BufferTree*                 left_;                 // Left node
+    BufferTree*                 right_;                // Right node
     LibraryCell*                buffer_cell_;          // Buffer cell type
     InstanceTerm*               pin_;                  // Buffered pin
     LibraryTerm*                library_pin_;          // Buffered pin type
@@ -99,8 +111,8 @@ public:
                InstanceTerm* pin = nullptr, LibraryCell* buffer_cell = nullptr,
                int        polarity    = 0,
                BufferMode buffer_mode = BufferMode::TimingDriven);
-    BufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
-               std::shared_ptr<BufferTree> right, Point location);
+    BufferTree(Psn* psn_inst, BufferTree* left, BufferTree* right,
+               Point location);
     float         totalCapacitance() const;
     float         capacitance() const;
     float         requiredOrSlew() const;
@@ -145,14 +157,14 @@ public:
     bool hasDownstreamSlewViolation(Psn* psn_inst, float slew_limit,
                                     float tr_slew = 0.0);
 
-    LibraryTerm*                 libraryPin() const;
-    std::shared_ptr<BufferTree>& left();
-    std::shared_ptr<BufferTree>& right();
-    void                         setLeft(std::shared_ptr<BufferTree> left);
-    void                         setRight(std::shared_ptr<BufferTree> right);
-    bool                         hasUpstreamBufferCell() const;
-    bool                         hasBufferCell() const;
-    bool                         hasDriverCell() const;
+    LibraryTerm* libraryPin() const;
+    BufferTree*  left() const;
+    BufferTree*  right() const;
+    void         setLeft(BufferTree* left);
+    void         setRight(BufferTree* right);
+    bool         hasUpstreamBufferCell() const;
+    bool         hasBufferCell() const;
+    bool         hasDriverCell() const;
 
     LibraryCell* bufferCell() const;
     LibraryCell* upstreamBufferCell() const;
@@ -187,8 +199,46 @@ public:
                         LibraryTerm*  library_pin = nullptr,
                         InstanceTerm* pin         = nullptr,
                         LibraryCell* buffer_cell = nullptr, int polarity = 0);
-    TimerlessBufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
-                        std::shared_ptr<BufferTree> right, Point location);
+    TimerlessBufferTree(Psn* psn_inst, BufferTree* left, BufferTree* right,
+                        Point location);
+};
+
+// Owns the candidate buffer tree nodes of a single buffering run; nodes are
+// allocated in blocks and released together by reset().
+class BufferTreeArena
+{
+    std::vector<std::unique_ptr<BufferTree[]>> blocks_;     // Node storage
+    size_t                                     block_size_; // Nodes per block
+    size_t                                     size_;       // Used nodes
+
+    BufferTree* allocate();
+
+public:
+    explicit BufferTreeArena(size_t block_size = 4096);
+    BufferTreeArena(const BufferTreeArena&) = delete;
+    BufferTreeArena& operator=(const BufferTreeArena&) = delete;
+
+    template <typename... Args>
+    BufferTree*
+    create(Args&&... args)
+    {
+        BufferTree* node = allocate();
+        *node            = BufferTree(std::forward<Args>(args)...);
+        return node;
+    }
+    template <typename... Args>
+    BufferTree*
+    createTimerless(Args&&... args)
+    {
+        BufferTree* node = create(std::forward<Args>(args)...);
+        node->setMode(BufferMode::Timerless);
+        return node;
+    }
+
+    // Invalidates all the allocated nodes, the storage is kept for reuse.
+    void   reset();
+    size_t size() const;
+    size_t capacity() const;
 };
 
 // Options to customize the optimization
@@ -233,6 +283,9 @@ public:
         current_iteration                = 0;
         capacitance_pessimism_factor     = 1.0;
         transition_pessimism_factor      = 1.0;
+        squeeze_pruning                  = false;
+        max_buffer_candidates            = 0;
+        buffering_threads                = 1;
     }
     float initial_area;             // Area before the optimization
     int   max_iterations;           // Maximum number of optimization iterations
@@ -287,46 +340,106 @@ public:
                                         // violations
     float transition_pessimism_factor;  // Scaling factor for transition
                                         // violations
+    bool   squeeze_pruning;       // Prune candidates below the convex hull
+    size_t max_buffer_candidates; // Maximum candidates per Steiner node (0 for
+                                  // no limit)
+    int buffering_threads; // Threads building the buffer candidates of
+                           // different nets concurrently
+};
+
+// Structure-of-arrays table of candidate buffer trees; keeps the pruning keys
+// in contiguous arrays and the tree topology to the side.
+class BufferCandidates
+{
+public:
+    std::vector<float>       capacitance;      // Total capacitance
+    std::vector<float>       required_or_slew; // Total required time or slew
+    std::vector<float>       cost;             // Tree cost
+    std::vector<int>         polarity;         // Tree polarity
+    std::vector<int>         buffer_count;     // Number of buffer cells
+    std::vector<BufferTree*> tree;  // Candidate tree, nullptr if not created
+    std::vector<BufferTree*> left;  // Left branch of a pending merge
+    std::vector<BufferTree*> right; // Right branch of a pending merge
+
+    void   clear();
+    void   reserve(size_t count);
+    size_t size() const;
+    // Adds an existing tree
+    void add(BufferTree* candidate_tree);
+    // Adds the merge of two branches without creating the tree
+    void add(float cap, float req_or_slew, float candidate_cost,
+             int candidate_polarity, int candidate_buffer_count,
+             BufferTree* left_branch, BufferTree* right_branch);
+    // Keeps only the candidates at the specified indices in order
+    void select(const std::vector<size_t>& indices);
 };
 
 // Represents a set of non-dominatd candidate buffer trees.
 class BufferSolution
 {
-    std::vector<std::shared_ptr<BufferTree>> buffer_trees_;
-    BufferMode                               mode_;
+    std::vector<BufferTree*> buffer_trees_;
+    BufferMode               mode_;
+    BufferTreeArena*         arena_;      // Owner of the candidate nodes
+    BufferCandidates         candidates_; // Pruning table
+    float approximation_loss_; // Required time (or slew) lost by limiting the
+                               // number of candidates
+
+    float pruneCandidates(Psn* psn_inst, LibraryCell* upstream_res_cell,
+                          float       minimum_upstream_res_or_max_slew,
+                          const float cap_prune_threshold,
+                          const float cost_prune_threshold,
+                          bool squeeze_pruning, size_t max_candidates);
+    void  squeezeCandidates(std::vector<size_t>& order,
+                            float minimum_upstream_res = 0.0);
+    float limitCandidates(std::vector<size_t>& order, size_t max_candidates);
+    void  materializeCandidates(Psn* psn_inst, Point location);
+
+    // Post-order traversal over an explicit stack for both bottom-up variants,
+    // leaf resynthesis is only applied at the starting point
+    static std::shared_ptr<BufferSolution> bottomUpTraversal(
+        Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt,
+        SteinerPoint prev, SteinerTree* st_tree,
+        std::unique_ptr<OptimizationOptions>&                 options,
+        std::vector<std::shared_ptr<LibraryCellMappingNode>>* mapping_terminals,
+        BufferTreeArena& arena, const SinkTimingSnapshot* sinks);
 
 public:
-    BufferSolution(BufferMode buffer_mode = BufferMode::TimingDriven);
+    BufferSolution(BufferTreeArena& arena,
+                   BufferMode       buffer_mode = BufferMode::TimingDriven);
     BufferSolution(Psn* psn_inst, std::shared_ptr<BufferSolution>& left,
                    std::shared_ptr<BufferSolution>& right, Point location,
                    LibraryCell* upstream_res_cell,
                    float        minimum_upstream_res_or_max_slew,
-                   BufferMode   buffer_mode = BufferMode::TimingDriven);
+                   BufferMode   buffer_mode     = BufferMode::TimingDriven,
+                   bool         squeeze_pruning = false,
+                   size_t       max_candidates  = 0);
 
-    // van Ginneken buffer algorithm bottom-up
+    // van Ginneken buffer algorithm bottom-up, the sink timing is read from
+    // the snapshot when it is given
     static std::shared_ptr<BufferSolution>
     bottomUp(Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt,
              SteinerPoint prev, std::shared_ptr<SteinerTree> st_tree,
-             std::unique_ptr<OptimizationOptions>& options);
+             std::unique_ptr<OptimizationOptions>& options,
+             BufferTreeArena&                      arena,
+             const SinkTimingSnapshot*             sinks = nullptr);
 
     // van Ginneken buffer algorithm bottom-up with resynthesis support
     static std::shared_ptr<BufferSolution> bottomUpWithResynthesis(
         Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt,
         SteinerPoint prev, std::shared_ptr<SteinerTree> st_tree,
         std::unique_ptr<OptimizationOptions>&                 options,
-        std::vector<std::shared_ptr<LibraryCellMappingNode>>& mapping_terminals);
+        std::vector<std::shared_ptr<LibraryCellMappingNode>>& mapping_terminals,
+        BufferTreeArena&                                      arena);
 
     // van Ginneken buffer algorithm top-down
-    static void topDown(Psn* psn_inst, Net* net,
-                        std::shared_ptr<BufferTree> tree, float& area,
+    static void topDown(Psn* psn_inst, Net* net, BufferTree* tree, float& area,
                         int& net_index, int& buff_index,
                         std::unordered_set<Instance*>& added_buffers,
                         std::unordered_set<Net*>&      affected_nets);
 
     // van Ginneken buffer algorithm top-down
-    static void topDown(Psn* psn_inst, InstanceTerm* pin,
-                        std::shared_ptr<BufferTree> tree, float& area,
-                        int& net_index, int& buff_index,
+    static void topDown(Psn* psn_inst, InstanceTerm* pin, BufferTree* tree,
+                        float& area, int& net_index, int& buff_index,
                         std::unordered_set<Instance*>& added_buffers,
                         std::unordered_set<Net*>&      affected_nets);
 
@@ -334,13 +447,17 @@ public:
     void mergeBranches(Psn* psn_inst, std::shared_ptr<BufferSolution>& left,
                        std::shared_ptr<BufferSolution>& right, Point location,
                        LibraryCell* upstream_res_cell,
-                       float        minimum_upstream_res_or_max_slew);
+                       float        minimum_upstream_res_or_max_slew,
+                       bool squeeze_pruning = false, size_t max_candidates = 0);
 
     // Add new candidate tree
-    void addTree(std::shared_ptr<BufferTree>& tree);
+    void addTree(BufferTree* tree);
 
     // Returns included candidate trees
-    std::vector<std::shared_ptr<BufferTree>>& bufferTrees();
+    std::vector<BufferTree*>& bufferTrees();
+
+    // Returns the arena owning the candidate trees
+    BufferTreeArena* arena() const;
 
     // Addd wire parasitics
     void addWireDelayAndCapacitance(float wire_res, float wire_cap);
@@ -359,45 +476,39 @@ public:
         std::vector<LibraryCell*>& inverter_lib,
         std::vector<std::shared_ptr<LibraryCellMappingNode>>&
             mappings_terminals);
-    void addUpstreamReferences(Psn*                        psn_inst,
-                               std::shared_ptr<BufferTree> base_buffer_tree);
+    void addUpstreamReferences(Psn* psn_inst, BufferTree* base_buffer_tree);
 
     // Returns the maximum required time tree with driver resizing
-    std::shared_ptr<BufferTree>
+    BufferTree*
     optimalDriverTreeWithResize(Psn* psn_inst, InstanceTerm* driver_pin,
                                 std::vector<LibraryCell*> driver_types,
                                 float                     area_penalty);
 
     // Returns the maximum required time tree with resynthesis support
-    std::shared_ptr<BufferTree>
+    BufferTree*
     optimalDriverTreeWithResynthesis(Psn* psn_inst, InstanceTerm* driver_pin,
                                      float  area_penalty,
                                      float* tree_slack = nullptr);
     // Not used
-    std::shared_ptr<BufferTree>
+    BufferTree*
     optimalTimerlessDriverTree(Psn* psn_inst, InstanceTerm* driver_pin);
 
     // Returns the maximum required time tree
-    std::shared_ptr<BufferTree>
-    optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                      std::shared_ptr<BufferTree>& inverted_sol,
-                      float*                       tree_slack = nullptr);
+    BufferTree* optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
+                                  BufferTree*& inverted_sol,
+                                  float*       tree_slack = nullptr);
 
     // Returns minimum cost tree that satisfies cap_limit
-    std::shared_ptr<BufferTree>
-    optimalCapacitanceTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                           std::shared_ptr<BufferTree>& inverted_sol,
-                           float                        cap_limit);
+    BufferTree* optimalCapacitanceTree(Psn* psn_inst, InstanceTerm* driver_pin,
+                                       BufferTree*& inverted_sol,
+                                       float        cap_limit);
     // Returns minimum cost tree that satisfies slew_limit
-    std::shared_ptr<BufferTree>
-    optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                    std::shared_ptr<BufferTree>& inverted_sol,
-                    float                        slew_limit);
+    BufferTree* optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
+                                BufferTree*& inverted_sol, float slew_limit);
     // Returns minimum cost tree that satisfies slew_limit and cap_limit
-    std::shared_ptr<BufferTree>
-    optimalCostTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                    std::shared_ptr<BufferTree>& inverted_sol, float slew_limit,
-                    float cap_limit);
+    BufferTree* optimalCostTree(Psn* psn_inst, InstanceTerm* driver_pin,
+                                BufferTree*& inverted_sol, float slew_limit,
+                                float cap_limit);
 
     // Helper fuzzy comparisons
     static bool isGreater(float first, float second, float threshold = 1E-6F);
@@ -410,7 +521,12 @@ public:
     void prune(Psn* psn_inst, LibraryCell* upstream_res_cell,
                float       minimum_upstream_res_or_max_slew,
                const float cap_prune_threshold  = 1E-6F,
-               const float cost_prune_threshold = 1E-6F);
+               const float cost_prune_threshold = 1E-6F,
+               bool squeeze_pruning = false, size_t max_candidates = 0);
+
+    // Upper bound of the required time (or slew) lost in the subtree by
+    // limiting the number of candidates per node
+    float approximationLoss() const;
 
     // Not used
     void       setMode(BufferMode buffer_mode);
@@ -422,12 +538,14 @@ class TimerlessBufferSolution : public BufferSolution
 {
 
 public:
-    TimerlessBufferSolution();
+    TimerlessBufferSolution(BufferTreeArena& arena);
     TimerlessBufferSolution(Psn*                             psn_inst,
                             std::shared_ptr<BufferSolution>& left,
                             std::shared_ptr<BufferSolution>& right,
                             Point location, LibraryCell* upstream_res_cell,
                             float      minimum_upstream_res_or_max_slew,
-                            BufferMode buffer_mode = BufferMode::TimingDriven);
+                            BufferMode buffer_mode = BufferMode::TimingDriven,
+                            bool       squeeze_pruning = false,
+                            size_t     max_candidates  = 0);
 };
 } // namespace psn
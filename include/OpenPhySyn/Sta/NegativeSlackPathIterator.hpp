@@ -0,0 +1,76 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "OpenPhySyn/Database/Types.hpp"
+#include "OpenPhySyn/Sta/PathArena.hpp"
+#include "OpenPhySyn/Sta/PathPoint.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace psn
+{
+class DatabaseHandler;
+
+// Streams the negative slack paths from the worst endpoint. The endpoints are
+// kept in a heap of their slacks and a path is only expanded when it is
+// requested, so the consumers that stop early do not pay for the whole list.
+class NegativeSlackPathIterator
+{
+public:
+    NegativeSlackPathIterator(
+        const DatabaseHandler*                       handler,
+        std::vector<std::pair<float, InstanceTerm*>> endpoints,
+        size_t max_paths = 0, size_t max_depth = 0);
+
+    bool hasNext() const;
+    // Endpoint of the next worst path without expanding it
+    InstanceTerm* nextEndpoint(float* slack = nullptr);
+    // Worst slack path of the next endpoint, only its last max_depth points
+    // are kept when the depth is limited
+    std::vector<PathPoint> next();
+    // Append the next path to the arena
+    void next(PathArena& paths);
+    // Number of negative slack endpoints
+    size_t count() const;
+
+private:
+    const DatabaseHandler*                       handler_;
+    std::vector<std::pair<float, InstanceTerm*>> heap_; // Remaining endpoints
+    size_t                                       count_;
+    size_t max_paths_; // Maximum number of returned paths, 0 for all
+    size_t max_depth_; // Maximum points of a returned path, 0 for all
+    size_t returned_;  // Number of returned paths
+};
+} // namespace psn
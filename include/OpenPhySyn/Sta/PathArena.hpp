@@ -0,0 +1,104 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "OpenPhySyn/Sta/PathPoint.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace psn
+{
+// Read-only view of the points of one path stored in a PathArena
+class PathRange
+{
+public:
+    PathRange(const PathPoint* first, const PathPoint* last);
+    const PathPoint* begin() const;
+    const PathPoint* end() const;
+    size_t           size() const;
+    bool             empty() const;
+    const PathPoint& operator[](size_t index) const;
+    const PathPoint& front() const;
+    const PathPoint& back() const;
+
+private:
+    const PathPoint* first_;
+    const PathPoint* last_;
+};
+
+// PathArena stores many paths in a single point buffer, each path is a
+// range of the buffer given by its offset. The paths are appended point by
+// point and the storage is reused across clear() calls.
+class PathArena
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const PathArena* arena, size_t index);
+        PathRange operator*() const;
+        Iterator& operator++();
+        bool      operator!=(const Iterator& other) const;
+
+    private:
+        const PathArena* arena_;
+        size_t           index_;
+    };
+
+    PathArena();
+    void reserve(size_t path_count, size_t point_count);
+    // Drop the paths, the storage is kept
+    void clear();
+    // Start a new empty path, the following points are added to it
+    void beginPath();
+    void addPoint(const PathPoint& point);
+    void addPath(const std::vector<PathPoint>& path);
+    // Keep only the first path_count paths
+    void truncate(size_t path_count);
+
+    size_t    size() const;
+    bool      empty() const;
+    size_t    pointCount() const;
+    PathRange path(size_t index) const;
+    PathRange operator[](size_t index) const;
+    Iterator  begin() const;
+    Iterator  end() const;
+    // Copy of the paths, one vector per path
+    std::vector<std::vector<PathPoint>> toVectors() const;
+
+private:
+    std::vector<PathPoint> points_;
+    std::vector<uint32_t>  offsets_; // First point of each path
+};
+} // namespace psn
@@ -33,6 +33,8 @@
 
 #include "OpenPhySyn/Database/Types.hpp"
 
+#include <cstdint>
+
 namespace sta
 {
 class PathAnalysisPoint;
@@ -46,20 +48,20 @@ public:
     PathPoint(InstanceTerm* path_pin = nullptr, bool is_rise = false,
               float path_arrival = 0, float path_required = 0,
               float path_slack = 0, PathAnalysisPoint* pt = nullptr);
-    InstanceTerm*      pin() const;
-    bool               isRise() const;
-    float              arrival() const;
-    float              required() const;
-    float              slack() const;
-    int                analysisPointIndex() const;
-    PathAnalysisPoint* analysisPoint() const;
+    InstanceTerm* pin() const;
+    bool          isRise() const;
+    float         arrival() const;
+    float         required() const;
+    float         slack() const;
+    int           analysisPointIndex() const;
 
 private:
-    InstanceTerm*      pin_;
-    bool               is_rise_;
-    float              arrival_;
-    float              required_;
-    float              slack_;
-    PathAnalysisPoint* path_ap_;
+    // The analysis point is kept as its index to pack the point in 24 bytes
+    InstanceTerm* pin_;
+    float         arrival_;
+    float         required_;
+    float         slack_;
+    int16_t       path_ap_index_; // -1 without an analysis point
+    bool          is_rise_;
 };
 } // namespace psn
\ No newline at end of file
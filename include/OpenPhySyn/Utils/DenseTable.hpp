@@ -0,0 +1,163 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace psn
+{
+
+// Vector-backed attribute table keyed by the dense object IDs of
+// DatabaseHandler, the storage grows to the largest ID written.
+template <typename T>
+class DenseTable
+{
+public:
+    DenseTable(T default_value = T()) : default_(default_value)
+    {
+    }
+
+    bool
+    contains(size_t id) const
+    {
+        return id < present_.size() && present_[id];
+    }
+
+    T&
+    operator[](size_t id)
+    {
+        if (id >= values_.size())
+        {
+            values_.resize(id + 1, default_);
+            present_.resize(id + 1, 0);
+        }
+        present_[id] = 1;
+        return values_[id];
+    }
+
+    // Stored value, or the default value if the ID was never written
+    const T&
+    value(size_t id) const
+    {
+        return contains(id) ? values_[id] : default_;
+    }
+
+    void
+    erase(size_t id)
+    {
+        if (contains(id))
+        {
+            present_[id] = 0;
+            values_[id]  = default_;
+        }
+    }
+
+    void
+    clear()
+    {
+        values_.clear();
+        present_.clear();
+    }
+
+private:
+    std::vector<T>    values_;  // Values indexed by ID
+    std::vector<char> present_; // Written IDs
+    T                 default_; // Value of the unwritten IDs
+};
+
+// Set of objects keyed by their dense IDs. Membership is a byte test, the
+// items are iterated in insertion order and clearing only touches the
+// inserted IDs so the set can be reused cheaply.
+template <typename T>
+class DenseSet
+{
+public:
+    bool
+    insert(size_t id, T item)
+    {
+        if (id >= members_.size())
+        {
+            members_.resize(id + 1, 0);
+        }
+        if (members_[id])
+        {
+            return false;
+        }
+        members_[id] = 1;
+        ids_.push_back(id);
+        items_.push_back(item);
+        return true;
+    }
+
+    bool
+    contains(size_t id) const
+    {
+        return id < members_.size() && members_[id];
+    }
+
+    const std::vector<T>&
+    items() const
+    {
+        return items_;
+    }
+
+    size_t
+    size() const
+    {
+        return items_.size();
+    }
+
+    bool
+    empty() const
+    {
+        return items_.empty();
+    }
+
+    void
+    clear()
+    {
+        for (auto id : ids_)
+        {
+            members_[id] = 0;
+        }
+        ids_.clear();
+        items_.clear();
+    }
+
+private:
+    std::vector<char>   members_; // Membership indexed by ID
+    std::vector<size_t> ids_;     // Inserted IDs
+    std::vector<T>      items_;   // Inserted items
+};
+
+} // namespace psn
@@ -30,7 +30,10 @@
 // POSSIBILITY OF SUCH DAMAGE.
 #include "OpenPhySyn/Database/DatabaseHandler.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <set>
 #include "OpenPhySyn/Database/Types.hpp"
 #include "OpenPhySyn/Liberty/LibraryMapping.hpp"
@@ -40,6 +43,7 @@
 #include "OpenPhySyn/Sta/DatabaseStaNetwork.hpp"
 #include "OpenPhySyn/Utils/ClusteringUtils.hpp"
 #include "OpenPhySyn/Utils/PsnGlobal.hpp"
+#include "Utils/FileUtils.hpp"
 #include "opendb/geom.h"
 #include "sta/ArcDelayCalc.hh"
 #include "sta/Bfs.hh"
@@ -66,6 +70,9 @@
 #include "sta/TimingRole.hh"
 #include "sta/Transition.hh"
 #include "sta/Units.hh"
+#ifdef TF_ENABLED
+#include "taskflow/taskflow.hpp"
+#endif
 
 namespace psn
 {
@@ -78,10 +85,22 @@ DatabaseHandler::DatabaseHandler(Psn* psn_inst, DatabaseSta* sta)
       psn_(psn_inst),
       has_wire_rc_(false),
       maximum_area_valid_(false),
+      parasitics_threads_(1),
+      clock_nets_valid_(false),
+      driver_index_valid_(false),
+      driver_order_valid_(false),
+      commutative_class_count_(0),
+      characterization_key_valid_(false),
+      timing_edit_depth_(0),
+      rolling_back_(false),
+      penalty_curve_start_(0.0),
+      penalty_curve_step_(0.0),
+      penalty_curve_error_(0.0),
       has_library_cell_mappings_(false),
       capacitance_limits_initialized_(false),
       slew_limits_initialized_(false),
-      fanout_limits_initialized_(false)
+      fanout_limits_initialized_(false),
+      main_thread_(std::this_thread::get_id())
 {
     // Use default corner for now
     corner_                      = sta_->findCorner("default");
@@ -99,29 +118,65 @@ DatabaseHandler::DatabaseHandler(Psn* psn_inst, DatabaseSta* sta)
     resetDelays();
 }
 
+// Power and ground pins are not part of the timing netlist
+static bool
+isSignalTerm(odb::dbITerm* iterm)
+{
+    return iterm->getSigType() != odb::dbSigType::POWER &&
+           iterm->getSigType() != odb::dbSigType::GROUND;
+}
+
 std::vector<InstanceTerm*>
 DatabaseHandler::pins(Net* net) const
 {
     std::vector<InstanceTerm*> terms;
-    auto                       pin_iter = network()->pinIterator(net);
-    while (pin_iter->hasNext())
-    {
-        InstanceTerm* pin = pin_iter->next();
-        terms.push_back(pin);
-    }
+    pins(net, terms);
     return terms;
 }
 std::vector<InstanceTerm*>
 DatabaseHandler::pins(Instance* inst) const
 {
     std::vector<InstanceTerm*> terms;
-    auto                       pin_iter = network()->pinIterator(inst);
-    while (pin_iter->hasNext())
+    pins(inst, terms);
+    return terms;
+}
+void
+DatabaseHandler::pins(Net* net, std::vector<InstanceTerm*>& terms) const
+{
+    terms.clear();
+    if (!net)
     {
-        InstanceTerm* pin = pin_iter->next();
-        terms.push_back(pin);
+        return;
+    }
+    // Walk the database set directly, the network pin iterators are heap
+    // allocated
+    for (auto iterm : network()->staToDb(net)->getITerms())
+    {
+        if (isSignalTerm(iterm))
+        {
+            terms.push_back(network()->dbToSta(iterm));
+        }
+    }
+}
+void
+DatabaseHandler::pins(Instance* inst, std::vector<InstanceTerm*>& terms) const
+{
+    terms.clear();
+    if (inst == network()->topInstance())
+    {
+        for (auto bterm : network()->block()->getBTerms())
+        {
+            terms.push_back(network()->dbToSta(bterm));
+        }
+        return;
+    }
+    for (auto iterm : network()->staToDb(inst)->getITerms())
+    {
+        if (isSignalTerm(iterm))
+        {
+            terms.push_back(network()->dbToSta(iterm));
+        }
     }
-    return terms;
 }
 Net*
 DatabaseHandler::net(InstanceTerm* term) const
@@ -142,14 +197,23 @@ std::vector<InstanceTerm*>
 DatabaseHandler::connectedPins(Net* net) const
 {
     std::vector<InstanceTerm*> terms;
-    auto                       pin_iter = network()->connectedPinIterator(net);
-    while (pin_iter->hasNext())
+    connectedPins(net, terms);
+    return terms;
+}
+void
+DatabaseHandler::connectedPins(Net*                        net,
+                               std::vector<InstanceTerm*>& terms) const
+{
+    pins(net, terms);
+    if (!net)
     {
-        InstanceTerm* pin = pin_iter->next();
-        terms.push_back(pin);
+        return;
+    }
+    for (auto bterm : network()->staToDb(net)->getBTerms())
+    {
+        terms.push_back(network()->dbToSta(bterm));
     }
     std::sort(terms.begin(), terms.end(), sta::PinPathNameLess(network()));
-    return terms;
 }
 Net*
 DatabaseHandler::bufferNet(Net* b_net, LibraryCell* buffer,
@@ -163,6 +227,10 @@ DatabaseHandler::bufferNet(Net* b_net, LibraryCell* buffer,
     connect(b_net, buf_inst, buff_in_port);
     connect(buf_net, buf_inst, buff_out_port);
     setLocation(buf_inst, location);
+    if (b_net && buf_net)
+    {
+        setClock(buf_net, isClock(b_net));
+    }
     if (b_net && hasWireRC())
     {
         calculateParasitics(b_net);
@@ -199,44 +267,73 @@ DatabaseHandler::clockPins() const
 std::vector<InstanceTerm*>
 DatabaseHandler::inputPins(Instance* inst, bool include_top_level) const
 {
-    auto inst_pins = pins(inst);
-    return filterPins(inst_pins, PinDirection::input(), include_top_level);
+    std::vector<InstanceTerm*> terms;
+    inputPins(inst, terms, include_top_level);
+    return terms;
 }
 
 std::vector<InstanceTerm*>
 DatabaseHandler::outputPins(Instance* inst, bool include_top_level) const
 {
-    auto inst_pins = pins(inst);
-    return filterPins(inst_pins, PinDirection::output(), include_top_level);
+    std::vector<InstanceTerm*> terms;
+    outputPins(inst, terms, include_top_level);
+    return terms;
 }
 
 std::vector<InstanceTerm*>
 DatabaseHandler::fanoutPins(Net* pin_net, bool include_top_level) const
 {
-    auto inst_pins = pins(pin_net);
+    std::vector<InstanceTerm*> terms;
+    fanoutPins(pin_net, terms, include_top_level);
+    return terms;
+}
+
+void
+DatabaseHandler::inputPins(Instance* inst, std::vector<InstanceTerm*>& terms,
+                           bool include_top_level) const
+{
+    pins(inst, terms);
+    retainPins(terms, PinDirection::input());
+}
 
-    auto filtered_inst_pins =
-        filterPins(inst_pins, PinDirection::input(), include_top_level);
+void
+DatabaseHandler::outputPins(Instance* inst, std::vector<InstanceTerm*>& terms,
+                            bool include_top_level) const
+{
+    pins(inst, terms);
+    retainPins(terms, PinDirection::output());
+}
 
-    if (include_top_level)
+void
+DatabaseHandler::fanoutPins(Net* pin_net, std::vector<InstanceTerm*>& terms,
+                            bool include_top_level) const
+{
+    pins(pin_net, terms);
+    retainPins(terms, PinDirection::input());
+    if (include_top_level && pin_net)
     {
-        std::vector<InstanceTerm*> filtered_top_pins;
-        auto itr = network()->connectedPinIterator(pin_net);
-        while (itr->hasNext())
+        for (auto bterm : network()->staToDb(pin_net)->getBTerms())
         {
-            InstanceTerm* term = itr->next();
-            if (network()->isTopLevelPort(term) &&
-                network()->direction(term)->isOutput())
+            InstanceTerm* term = network()->dbToSta(bterm);
+            if (network()->direction(term)->isOutput())
             {
-                filtered_top_pins.push_back(term);
+                terms.push_back(term);
             }
         }
-        delete itr;
-        filtered_inst_pins.insert(filtered_inst_pins.end(),
-                                  filtered_top_pins.begin(),
-                                  filtered_top_pins.end());
     }
-    return filtered_inst_pins;
+}
+
+void
+DatabaseHandler::retainPins(std::vector<InstanceTerm*>& terms,
+                            PinDirection*               direction) const
+{
+    terms.erase(std::remove_if(terms.begin(), terms.end(),
+                               [&](InstanceTerm* term) -> bool {
+                                   return !network()->instance(term) ||
+                                          network()->direction(term) !=
+                                              direction;
+                               }),
+                terms.end());
 }
 
 bool
@@ -950,6 +1047,30 @@ std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>
 DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
                                 bool include_inverting)
 {
+    // The clusters only depend on the libraries and the arguments
+    uint32_t threshold_bits;
+    std::memcpy(&threshold_bits, &cluster_threshold, sizeof(threshold_bits));
+    std::string record_name = "buffer_clusters/" +
+                              std::to_string(threshold_bits) + "/" +
+                              std::to_string(find_superior) + "/" +
+                              std::to_string(include_inverting);
+    std::vector<std::string>  record_cells;
+    std::vector<float>        record_values;
+    std::vector<LibraryCell*> record_lib_cells;
+    CharacterizationCache*    cache = characterizationCache();
+    if (cache && cache->find(record_name, record_cells, record_values) &&
+        record_values.size() == 1 &&
+        record_values[0] <= record_cells.size() &&
+        characterizationCells(record_cells, record_lib_cells))
+    {
+        size_t buffer_count = record_values[0];
+        return std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>(
+            std::vector<LibraryCell*>(record_lib_cells.begin(),
+                                      record_lib_cells.begin() + buffer_count),
+            std::vector<LibraryCell*>(record_lib_cells.begin() + buffer_count,
+                                      record_lib_cells.end()));
+    }
+
     std::vector<LibraryCell*>        buffer_cells, inverter_cells;
     std::unordered_set<LibraryCell*> superior_buffer_cells,
         superior_inverter_cells;
@@ -1150,32 +1271,36 @@ DatabaseHandler::bufferClusters(float cluster_threshold, bool find_superior,
         buff_vector, buff_distances, cluster_threshold, 0);
     auto inverter_cluster = KCenterClustering::cluster<LibraryCell*>(
         inv_vector, inv_distances, cluster_threshold, 0);
+    if (cache)
+    {
+        record_cells.clear();
+        for (auto& cell : buffer_cluster)
+        {
+            record_cells.push_back(characterizationName(cell));
+        }
+        for (auto& cell : inverter_cluster)
+        {
+            record_cells.push_back(characterizationName(cell));
+        }
+        cache->insert(record_name, record_cells,
+                      std::vector<float>({float(buffer_cluster.size())}));
+        saveCharacterizationCache();
+    }
     return std::pair<std::vector<LibraryCell*>, std::vector<LibraryCell*>>(
         buffer_cluster, inverter_cluster);
 }
 std::unordered_set<InstanceTerm*>
 DatabaseHandler::commutativePins(InstanceTerm* term)
 {
-    std::unordered_set<LibraryTerm*> comm_lib_pins;
-    LibraryTerm*                     lib_pin = libraryPin(term);
-    if (!commutative_pins_cache_.count(lib_pin))
+    std::unordered_set<InstanceTerm*> comm;
+    int term_class = commutativeClass(libraryPin(term));
+    if (term_class < 0)
     {
-        comm_lib_pins.insert(lib_pin);
-        for (auto inp : libraryInputPins(lib_pin->libertyCell()))
-        {
-            if (inp != lib_pin && isCommutative(lib_pin, inp))
-            {
-                comm_lib_pins.insert(inp);
-            }
-        }
-        commutative_pins_cache_[lib_pin] = comm_lib_pins;
+        return comm;
     }
-    comm_lib_pins = commutative_pins_cache_[lib_pin];
-    std::unordered_set<InstanceTerm*> comm;
-
     for (auto& pn : inputPins(instance(term)))
     {
-        if (pn != term && comm_lib_pins.count(libraryPin(pn)))
+        if (pn != term && commutativeClass(libraryPin(pn)) == term_class)
         {
             comm.insert(pn);
         }
@@ -1281,9 +1406,21 @@ DatabaseHandler::criticalPaths(int path_count) const
     }
     return paths;
 }
+void
+DatabaseHandler::criticalPaths(PathArena& paths, int path_count) const
+{
+    getPaths(true, path_count, paths);
+    paths.truncate(path_count + 1);
+}
+void
+DatabaseHandler::bestPath(PathArena& paths, int path_count) const
+{
+    getPaths(false, path_count, paths);
+}
 std::vector<PathPoint>
 DatabaseHandler::worstSlackPath(InstanceTerm* term, bool trim) const
 {
+    flushParasitics();
     sta::PathRef path;
     // sta_->search()->endpointsInvalid();
     sta_->vertexWorstSlackPath(vertex(term), sta::MinMax::max(), path);
@@ -1304,6 +1441,7 @@ DatabaseHandler::worstSlackPath(InstanceTerm* term, bool trim) const
 std::vector<PathPoint>
 DatabaseHandler::worstArrivalPath(InstanceTerm* term) const
 {
+    flushParasitics();
     sta::PathRef path;
     sta_->vertexWorstArrivalPath(vertex(term), sta::MinMax::max(), path);
     return expandPath(&path);
@@ -1312,6 +1450,7 @@ DatabaseHandler::worstArrivalPath(InstanceTerm* term) const
 std::vector<PathPoint>
 DatabaseHandler::bestSlackPath(InstanceTerm* term) const
 {
+    flushParasitics();
     sta::PathRef path;
     sta_->vertexWorstSlackPath(vertex(term), sta::MinMax::min(), path);
     return expandPath(&path);
@@ -1319,6 +1458,7 @@ DatabaseHandler::bestSlackPath(InstanceTerm* term) const
 std::vector<PathPoint>
 DatabaseHandler::bestArrivalPath(InstanceTerm* term) const
 {
+    flushParasitics();
     sta::PathRef path;
     sta_->vertexWorstArrivalPath(vertex(term), sta::MinMax::min(), path);
     return expandPath(&path);
@@ -1326,6 +1466,7 @@ DatabaseHandler::bestArrivalPath(InstanceTerm* term) const
 float
 DatabaseHandler::pinSlack(InstanceTerm* term, bool is_rise, bool worst) const
 {
+    flushParasitics();
     return sta_->pinSlack(
         term, is_rise ? sta::RiseFall::rise() : sta::RiseFall::fall(),
         worst ? sta::MinMax::min() : sta::MinMax::max());
@@ -1333,6 +1474,7 @@ DatabaseHandler::pinSlack(InstanceTerm* term, bool is_rise, bool worst) const
 float
 DatabaseHandler::pinSlack(InstanceTerm* term, bool worst) const
 {
+    flushParasitics();
     return sta_->pinSlack(term,
                           worst ? sta::MinMax::min() : sta::MinMax::max());
 }
@@ -1349,6 +1491,7 @@ DatabaseHandler::slew(InstanceTerm* term) const
 float
 DatabaseHandler::slew(InstanceTerm* term, bool is_rise) const
 {
+    flushParasitics();
     if (network()->direction(term)->isInput())
     {
         return sta_->vertexSlew(vertex(term),
@@ -1378,7 +1521,7 @@ DatabaseHandler::slew(InstanceTerm* term, bool is_rise) const
 float
 DatabaseHandler::arrival(InstanceTerm* term, int ap_index, bool is_rise) const
 {
-
+    flushParasitics();
     return sta_->vertexArrival(
         vertex(term), is_rise ? sta::RiseFall::rise() : sta::RiseFall::fall(),
         sta_->corners()->findPathAnalysisPt(ap_index));
@@ -1386,6 +1529,7 @@ DatabaseHandler::arrival(InstanceTerm* term, int ap_index, bool is_rise) const
 float
 DatabaseHandler::required(InstanceTerm* term) const
 {
+    flushParasitics();
     auto vert = network()->graph()->pinLoadVertex(term);
     auto req  = sta_->vertexRequired(vert, min_max_);
     if (sta::fuzzyInf(req))
@@ -1398,6 +1542,7 @@ float
 DatabaseHandler::required(InstanceTerm* term, bool is_rise,
                           PathAnalysisPoint* path_ap) const
 {
+    flushParasitics();
     auto vert = network()->graph()->pinLoadVertex(term);
     auto req  = sta_->vertexRequired(
         vert, is_rise ? sta::RiseFall::rise() : sta::RiseFall::fall(), path_ap);
@@ -1410,6 +1555,14 @@ DatabaseHandler::required(InstanceTerm* term, bool is_rise,
 std::vector<std::vector<PathPoint>>
 DatabaseHandler::getPaths(bool get_max, int path_count) const
 {
+    PathArena paths;
+    getPaths(get_max, path_count, paths);
+    return paths.toVectors();
+}
+void
+DatabaseHandler::getPaths(bool get_max, int path_count, PathArena& paths) const
+{
+    flushParasitics();
     sta_->ensureGraph();
     sta_->searchPreamble();
 
@@ -1428,20 +1581,19 @@ DatabaseHandler::getPaths(bool get_max, int path_count) const
             // clk_gating_setup, clk_gating_hold
             true, true);
 
-    std::vector<std::vector<PathPoint>> result;
-
+    paths.clear();
     bool first_path = true;
     for (auto& path_end : *path_ends)
     {
-        result.push_back(expandPath(path_end, !first_path));
+        expandPath(path_end->path(), paths, !first_path);
         first_path = false;
     }
     delete path_ends;
-    return result;
 }
 InstanceTerm*
 DatabaseHandler::worstSlackPin() const
 {
+    flushParasitics();
     float   ws;
     Vertex* vert;
     sta_->findRequireds();
@@ -1453,6 +1605,7 @@ DatabaseHandler::worstSlackPin() const
 float
 DatabaseHandler::worstSlack(InstanceTerm* term) const
 {
+    flushParasitics();
     float ws;
     // sta_->findRequireds();
     auto vert = vertex(term);
@@ -1469,6 +1622,7 @@ DatabaseHandler::worstSlack(InstanceTerm* term) const
 float
 DatabaseHandler::worstSlack() const
 {
+    flushParasitics();
     float   ws;
     Vertex* vert;
     sta_->findRequireds();
@@ -1479,36 +1633,41 @@ DatabaseHandler::worstSlack() const
 std::vector<std::vector<PathPoint>>
 DatabaseHandler::getNegativeSlackPaths() const
 {
-    std::vector<std::vector<PathPoint>> result;
+    PathArena paths;
+    getNegativeSlackPaths(paths);
+    return paths.toVectors();
+}
+void
+DatabaseHandler::getNegativeSlackPaths(PathArena& paths) const
+{
+    auto path_iter = negativeSlackPaths();
+    paths.clear();
+    while (path_iter.hasNext())
+    {
+        path_iter.next(paths);
+    }
+}
+NegativeSlackPathIterator
+DatabaseHandler::negativeSlackPaths(size_t max_paths, size_t max_depth) const
+{
+    flushParasitics();
     sta_->ensureLevelized();
     sta_->search()->findAllArrivals();
     sta_->findRequireds();
 
+    // Only the endpoint slacks are collected, the paths are expanded by the
+    // iterator
+    std::vector<std::pair<float, InstanceTerm*>> endpoints;
     for (auto& vert : *sta_->search()->endpoints())
     {
-        sta::PathRef ref;
-        sta_->vertexWorstSlackPath(vert, sta::MinMax::max(), ref);
-        if (ref.tag(sta_))
+        float slack = sta_->vertexSlack(vert, sta::MinMax::max());
+        if (slack < 0.0)
         {
-            auto vertSlack = ref.slack(sta_);
-            if (vertSlack < 0.0)
-            {
-                result.push_back(expandPath(&ref));
-            }
+            endpoints.push_back(std::make_pair(slack, vert->pin()));
         }
     }
-    std::sort(result.begin(), result.end(),
-              [&](const std::vector<PathPoint>& p1,
-                  const std::vector<PathPoint>& p2) -> bool {
-                  return p1[p1.size() - 1].slack() < p2[p2.size() - 1].slack();
-              });
-    // Remove clock pin
-    for (auto& pth : result)
-    {
-        pth.erase(pth.begin());
-    }
-
-    return result;
+    return NegativeSlackPathIterator(this, std::move(endpoints), max_paths,
+                                     max_depth);
 }
 std::vector<PathPoint>
 DatabaseHandler::expandPath(sta::PathEnd* path_end, bool enumed) const
@@ -1523,22 +1682,36 @@ DatabaseHandler::expandPath(sta::Path* path, bool enumed) const
     sta::PathExpanded      expanded(path, sta_);
     for (size_t i = 1; i < expanded.size(); i++)
     {
-        auto ref           = expanded.path(i);
-        auto pin           = ref->vertex(sta_)->pin();
-        auto is_rising     = ref->transition(sta_) == sta::RiseFall::rise();
-        auto arrival       = ref->arrival(sta_);
-        auto path_ap       = ref->pathAnalysisPt(sta_);
-        auto path_required = enumed ? 0 : ref->required(sta_);
-        if (!path_required || sta::fuzzyInf(path_required))
-        {
-            path_required = required(pin, is_rising, path_ap);
-        }
-        auto slack = enumed ? path_required - arrival : ref->slack(sta_);
-        points.push_back(
-            PathPoint(pin, is_rising, arrival, path_required, slack, path_ap));
+        points.push_back(pathPoint(expanded.path(i), enumed));
     }
     return points;
 }
+void
+DatabaseHandler::expandPath(sta::Path* path, PathArena& paths,
+                            bool enumed) const
+{
+    sta::PathExpanded expanded(path, sta_);
+    paths.beginPath();
+    for (size_t i = 1; i < expanded.size(); i++)
+    {
+        paths.addPoint(pathPoint(expanded.path(i), enumed));
+    }
+}
+PathPoint
+DatabaseHandler::pathPoint(const sta::PathRef* ref, bool enumed) const
+{
+    auto pin           = ref->vertex(sta_)->pin();
+    auto is_rising     = ref->transition(sta_) == sta::RiseFall::rise();
+    auto arrival       = ref->arrival(sta_);
+    auto path_ap       = ref->pathAnalysisPt(sta_);
+    auto path_required = enumed ? 0 : ref->required(sta_);
+    if (!path_required || sta::fuzzyInf(path_required))
+    {
+        path_required = required(pin, is_rising, path_ap);
+    }
+    auto slack = enumed ? path_required - arrival : ref->slack(sta_);
+    return PathPoint(pin, is_rising, arrival, path_required, slack, path_ap);
+}
 
 bool
 DatabaseHandler::isCommutative(InstanceTerm* first, InstanceTerm* second) const
@@ -1553,98 +1726,136 @@ DatabaseHandler::isCommutative(LibraryTerm* first, LibraryTerm* second) const
     {
         return true;
     }
-    auto cell_lib = first->libertyCell();
-    if (cell_lib->isClockGate() || cell_lib->isPad() || cell_lib->isMacro() ||
-        cell_lib->hasSequentials())
+    if (first->libertyCell() != second->libertyCell())
     {
         return false;
     }
-    auto                      output_pins = libraryOutputPins(cell_lib);
-    auto                      input_pins  = libraryInputPins(cell_lib);
-    std::vector<LibraryTerm*> remaining_pins;
-    for (auto& pin : input_pins)
+    int first_class = commutativeClass(first);
+    return first_class >= 0 && first_class == commutativeClass(second);
+}
+int
+DatabaseHandler::commutativeClass(LibraryTerm* term) const
+{
+    auto class_itr = commutative_classes_.find(term);
+    if (class_itr == commutative_classes_.end())
+    {
+        findCommutativeClasses(term->libertyCell());
+        class_itr = commutative_classes_.find(term);
+    }
+    return class_itr != commutative_classes_.end() ? class_itr->second : -1;
+}
+void
+DatabaseHandler::findCommutativeClasses(Liberty* lib)
+{
+    sta::LibertyCellIterator cell_iter(lib);
+    while (cell_iter.hasNext())
+    {
+        findCommutativeClasses(cell_iter.next());
+    }
+}
+
+void
+DatabaseHandler::findCommutativeClasses(LibraryCell* cell) const
+{
+    // Truth tables of up to 16 inputs fit in 1024 words, wider cells are not
+    // swapped
+    const size_t max_inputs = 16;
+
+    std::vector<LibraryTerm*> cell_pins;
+    libraryPins(cell, cell_pins);
+    for (auto& pin : cell_pins)
+    {
+        commutative_classes_[pin] = -1;
+    }
+    std::vector<LibraryTerm*> input_pins;
+    std::vector<LibraryTerm*> output_pins;
+    libraryInputPins(cell, input_pins);
+    libraryOutputPins(cell, output_pins);
+    size_t input_count = input_pins.size();
+    if (cell->isClockGate() || cell->isPad() || cell->isMacro() ||
+        cell->hasSequentials() || input_count < 2 ||
+        input_count > max_inputs || !output_pins.size())
     {
-        if (pin != first && pin != second)
+        return;
+    }
+
+    std::vector<std::vector<uint64_t>> tables(output_pins.size());
+    for (size_t i = 0; i < output_pins.size(); i++)
+    {
+        if (!compiledFunction(output_pins[i]).truthTable(tables[i]))
         {
-            remaining_pins.push_back(pin);
+            return;
         }
     }
-    for (auto& out : output_pins)
-    {
-        sta::FuncExpr* func = out->function();
-        if (!func)
+
+    // Two inputs commute if swapping their values leaves every output
+    // unchanged, it is enough to compare the minterms where they differ
+    auto is_symmetric = [&](size_t first, size_t second) -> bool {
+        size_t minterms = size_t(1) << input_count;
+        size_t swap     = (size_t(1) << first) | (size_t(1) << second);
+        for (size_t m = 0; m < minterms; m++)
         {
-            return false;
+            if (!((m >> first) & 1) || ((m >> second) & 1))
+            {
+                continue;
+            }
+            size_t swapped = m ^ swap;
+            for (auto& table : tables)
+            {
+                if (((table[m >> 6] >> (m & 63)) & 1) !=
+                    ((table[swapped >> 6] >> (swapped & 63)) & 1))
+                {
+                    return false;
+                }
+            }
         }
-        if (func->hasPort(first) && func->hasPort(second))
+        return true;
+    };
+    std::vector<int> classes(input_count, -1);
+    for (size_t i = 0; i < input_count; i++)
+    {
+        for (size_t j = i + 1; j < input_count; j++)
         {
-            std::unordered_map<LibraryTerm*, int> sim_vals;
-            for (int i = 0; i < 2; i++)
+            if (classes[j] < 0 && is_symmetric(i, j))
             {
-                for (int j = 0; j < 2; j++)
+                if (classes[i] < 0)
                 {
-
-                    for (int m = 0; m < std::pow(2, remaining_pins.size()); m++)
-                    {
-                        sim_vals[first]  = i;
-                        sim_vals[second] = j;
-                        int temp         = m;
-                        for (auto& rp : remaining_pins)
-                        {
-                            sim_vals[rp] = temp & 1;
-                            temp         = temp >> 1;
-                        }
-                        int first_result =
-                            evaluateFunctionExpression(out, sim_vals);
-
-                        sim_vals[first]  = j;
-                        sim_vals[second] = i;
-                        int second_result =
-                            evaluateFunctionExpression(out, sim_vals);
-                        if (first_result != second_result ||
-                            first_result == -1 || second_result == -1)
-                        {
-                            return false;
-                        }
-                    }
+                    classes[i] = commutative_class_count_++;
                 }
+                classes[j] = classes[i];
             }
         }
+        commutative_classes_[input_pins[i]] = classes[i];
     }
-    return true;
 }
 std::vector<InstanceTerm*>
 DatabaseHandler::levelDriverPins(
-    bool reverse, std::unordered_set<InstanceTerm*> filter_pins) const
+    bool reverse, const std::unordered_set<InstanceTerm*>& filter_pins) const
 {
     sta_->ensureGraph();
     sta_->ensureLevelized();
-
-    auto handler_network = network();
+    if (!driver_index_valid_)
+    {
+        indexDriverPins();
+    }
+    if (!driver_order_valid_)
+    {
+        sortDriverPins();
+    }
 
     std::vector<InstanceTerm*> terms;
-    std::vector<Vertex*>       vertices;
-    sta::VertexIterator        itr(handler_network->graph());
-    while (itr.hasNext())
+    if (!filter_pins.size())
     {
-        Vertex* vtx = itr.next();
-        if (vtx->isDriver(handler_network))
-            vertices.push_back(vtx);
+        terms = driver_order_;
     }
-    std::sort(
-        vertices.begin(), vertices.end(),
-        [=](const Vertex* v1, const Vertex* v2) -> bool {
-            return (v1->level() < v2->level()) ||
-                   (v1->level() == v2->level() &&
-                    sta::stringLess(handler_network->pathName(v1->pin()),
-                                    handler_network->pathName(v2->pin())));
-        });
-    for (auto& v : vertices)
+    else
     {
-        auto pn = v->pin();
-        if (!filter_pins.size() || filter_pins.count(pn))
+        for (auto& pn : driver_order_)
         {
-            terms.push_back(v->pin());
+            if (filter_pins.count(pn))
+            {
+                terms.push_back(pn);
+            }
         }
     }
     if (reverse)
@@ -1653,6 +1864,108 @@ DatabaseHandler::levelDriverPins(
     }
     return terms;
 }
+void
+DatabaseHandler::invalidateDriverIndex()
+{
+    driver_index_valid_ = false;
+    driver_order_valid_ = false;
+    driver_index_.clear();
+    driver_order_.clear();
+}
+void
+DatabaseHandler::indexDriverPins() const
+{
+    driver_index_.clear();
+    sta::VertexIterator itr(network()->graph());
+    while (itr.hasNext())
+    {
+        Vertex* vtx = itr.next();
+        if (vtx->isDriver(network()))
+        {
+            auto pin_id = id(vtx->pin());
+            if (pin_id >= driver_index_.size())
+            {
+                driver_index_.resize(pin_id + 1, nullptr);
+            }
+            driver_index_[pin_id] = vtx->pin();
+        }
+    }
+    driver_index_valid_ = true;
+    driver_order_valid_ = false;
+}
+void
+DatabaseHandler::indexDriverPins(Instance* inst, bool is_removed) const
+{
+    driver_order_valid_ = false;
+    if (!driver_index_valid_)
+    {
+        return;
+    }
+    for (auto iterm : network()->staToDb(inst)->getITerms())
+    {
+        InstanceTerm* pin    = network()->dbToSta(iterm);
+        auto          pin_id = id(pin);
+        if (is_removed)
+        {
+            if (pin_id < driver_index_.size())
+            {
+                driver_index_[pin_id] = nullptr;
+            }
+        }
+        else if (network()->isDriver(pin))
+        {
+            if (pin_id >= driver_index_.size())
+            {
+                driver_index_.resize(pin_id + 1, nullptr);
+            }
+            driver_index_[pin_id] = pin;
+        }
+    }
+}
+void
+DatabaseHandler::sortDriverPins() const
+{
+    // Counting sort on the vertex level, the index is walked in ID order so
+    // the pins of the same level stay sorted by ID
+    auto driver_vertex = [&](InstanceTerm* pin) -> Vertex* {
+        Vertex *vert, *bi_vert;
+        network()->graph()->pinVertices(pin, vert, bi_vert);
+        return bi_vert ? bi_vert : vert;
+    };
+    level_counts_.clear();
+    size_t count = 0;
+    for (auto& pin : driver_index_)
+    {
+        auto vtx = pin ? driver_vertex(pin) : nullptr;
+        if (vtx)
+        {
+            size_t level = vtx->level();
+            if (level >= level_counts_.size())
+            {
+                level_counts_.resize(level + 1, 0);
+            }
+            level_counts_[level]++;
+            count++;
+        }
+    }
+    size_t offset = 0;
+    for (auto& level_count : level_counts_)
+    {
+        size_t next_offset = offset + level_count;
+        level_count        = offset;
+        offset             = next_offset;
+    }
+    driver_order_.resize(count);
+    for (auto& pin : driver_index_)
+    {
+        auto vtx = pin ? driver_vertex(pin) : nullptr;
+        if (vtx)
+        {
+            driver_order_[level_counts_[vtx->level()]++] = pin;
+        }
+    }
+    driver_order_valid_ = true;
+}
 
 InstanceTerm*
 DatabaseHandler::faninPin(InstanceTerm* term) const
@@ -1662,12 +1975,15 @@ DatabaseHandler::faninPin(InstanceTerm* term) const
 InstanceTerm*
 DatabaseHandler::faninPin(Net* net) const
 {
-    auto net_pins = pins(net);
-    for (auto& pin : net_pins)
+    if (!net)
     {
-        Instance* inst = network()->instance(pin);
-        if (inst)
+        return nullptr;
+    }
+    for (auto iterm : network()->staToDb(net)->getITerms())
+    {
+        if (isSignalTerm(iterm))
         {
+            InstanceTerm* pin = network()->dbToSta(iterm);
             if (network()->direction(pin)->isOutput())
             {
                 return pin;
@@ -1755,6 +2071,15 @@ void
 DatabaseHandler::setLocation(Instance* inst, Point pt)
 {
     odb::dbInst* dinst = network()->staToDb(inst);
+    if (journaling())
+    {
+        JournalEntry entry = JournalEntry();
+        entry.op           = JournalOp::Move;
+        entry.inst         = inst;
+        entry.flag         = isPlaced(inst);
+        dinst->getOrigin(entry.x, entry.y);
+        journal_.push_back(std::move(entry));
+    }
     dinst->setPlacementStatus(odb::dbPlacementStatus::PLACED);
     dinst->setLocation(pt.getX(), pt.getY());
 }
@@ -2099,28 +2424,13 @@ DatabaseHandler::slew(LibraryTerm* term, float load_cap, float* tr_slew)
 
     auto cell = term->libertyCell();
     // Max rise/fall delays.
-    sta::Slew                            max_slew = -sta::INF;
-    sta::LibertyCellTimingArcSetIterator set_iter(cell);
-    while (set_iter.hasNext())
+    sta::Slew max_slew = -sta::INF;
+    for (auto& arc : compiledArcs(term))
     {
-        sta::TimingArcSet* arc_set = set_iter.next();
-        if (arc_set->to() == term)
-        {
-            sta::TimingArcSetArcIterator arc_iter(arc_set);
-            while (arc_iter.hasNext())
-            {
-                sta::TimingArc* arc   = arc_iter.next();
-                sta::RiseFall*  in_rf = arc->fromTrans()->asRiseFall();
-                float           in_slew =
-                    tr_slew ? *tr_slew : target_slews_[in_rf->index()];
-                sta::ArcDelay gate_delay;
-                sta::Slew     drvr_slew;
-                sta_->arcDelayCalc()->gateDelay(cell, arc, in_slew, load_cap,
-                                                nullptr, 0.0, pvt_, dcalc_ap_,
-                                                gate_delay, drvr_slew);
-                max_slew = std::max(max_slew, drvr_slew);
-            }
-        }
+        float in_slew = tr_slew ? *tr_slew : target_slews_[arc.in_rf];
+        float gate_delay, drvr_slew;
+        arcDelay(cell, arc, in_slew, load_cap, gate_delay, drvr_slew);
+        max_slew = std::max(max_slew, drvr_slew);
     }
     return max_slew;
 }
@@ -2190,6 +2500,7 @@ DatabaseHandler::pinTableAverage(LibraryTerm* from, LibraryTerm* to,
 float
 DatabaseHandler::loadCapacitance(InstanceTerm* term) const
 {
+    flushParasitics();
     return network()->graphDelayCalc()->loadCap(term, dcalc_ap_);
 }
 Instance*
@@ -2244,47 +2555,90 @@ DatabaseHandler::libraryPins(Instance* inst) const
 std::vector<LibraryTerm*>
 DatabaseHandler::libraryPins(LibraryCell* cell) const
 {
-    std::vector<LibraryTerm*>    pins;
-    sta::LibertyCellPortIterator itr(cell);
-    while (itr.hasNext())
-    {
-        auto port = itr.next();
-        pins.push_back(port);
-    }
+    std::vector<LibraryTerm*> pins;
+    libraryPins(cell, pins);
     return pins;
 }
 std::vector<LibraryTerm*>
 DatabaseHandler::libraryInputPins(LibraryCell* cell) const
 {
-    auto pins = libraryPins(cell);
-    for (auto it = pins.begin(); it != pins.end(); it++)
-    {
-        if (!((*it)->direction()->isAnyInput()))
-        {
-            it = pins.erase(it);
-            it--;
-        }
-    }
+    std::vector<LibraryTerm*> pins;
+    libraryInputPins(cell, pins);
     return pins;
 }
 std::vector<LibraryTerm*>
 DatabaseHandler::libraryOutputPins(LibraryCell* cell) const
 {
-    auto pins = libraryPins(cell);
-    for (auto it = pins.begin(); it != pins.end(); it++)
+    std::vector<LibraryTerm*> pins;
+    libraryOutputPins(cell, pins);
+    return pins;
+}
+void
+DatabaseHandler::libraryPins(LibraryCell*               cell,
+                             std::vector<LibraryTerm*>& terms) const
+{
+    terms.clear();
+    sta::LibertyCellPortIterator itr(cell);
+    while (itr.hasNext())
+    {
+        terms.push_back(itr.next());
+    }
+}
+void
+DatabaseHandler::libraryInputPins(LibraryCell*               cell,
+                                  std::vector<LibraryTerm*>& terms) const
+{
+    terms.clear();
+    sta::LibertyCellPortIterator itr(cell);
+    while (itr.hasNext())
     {
-        if (!((*it)->direction()->isAnyOutput()))
+        auto port = itr.next();
+        if (port->direction()->isAnyInput())
         {
-            it = pins.erase(it);
-            it--;
+            terms.push_back(port);
         }
     }
-    return pins;
 }
-
-std::vector<InstanceTerm*>
-DatabaseHandler::filterPins(std::vector<InstanceTerm*>& terms,
-                            PinDirection*               direction,
+void
+DatabaseHandler::libraryOutputPins(LibraryCell*               cell,
+                                   std::vector<LibraryTerm*>& terms) const
+{
+    terms.clear();
+    sta::LibertyCellPortIterator itr(cell);
+    while (itr.hasNext())
+    {
+        auto port = itr.next();
+        if (port->direction()->isAnyOutput())
+        {
+            terms.push_back(port);
+        }
+    }
+}
+int
+DatabaseHandler::libraryPinCount(LibraryCell* cell, bool output,
+                                 LibraryTerm** first) const
+{
+    int                          count = 0;
+    sta::LibertyCellPortIterator itr(cell);
+    while (itr.hasNext())
+    {
+        auto port = itr.next();
+        if (output ? port->direction()->isAnyOutput()
+                   : port->direction()->isAnyInput())
+        {
+            if (!count && first)
+            {
+                *first = port;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+std::vector<InstanceTerm*>
+DatabaseHandler::filterPins(std::vector<InstanceTerm*>& terms,
+                            PinDirection*               direction,
                             bool                        include_top_level) const
 {
     std::vector<InstanceTerm*> inst_terms;
@@ -2328,19 +2682,83 @@ DatabaseHandler::isTopLevel(InstanceTerm* term) const
 void
 DatabaseHandler::del(Net* net) const
 {
+    if (journaling())
+    {
+        journalNet(net);
+        for (auto& pin : connectedPins(net))
+        {
+            journal(JournalOp::Disconnect, pin, net);
+        }
+        JournalEntry entry = JournalEntry();
+        entry.op           = JournalOp::DeleteNet;
+        entry.net          = net;
+        entry.name         = name(net);
+        entry.flag         = isClock(net);
+        journal_.push_back(std::move(entry));
+    }
+    dirty_nets_.erase(net);
+    eraseIds(net);
     sta_->deleteNet(net);
 }
 void
 DatabaseHandler::del(Instance* inst) const
 {
+    if (journaling())
+    {
+        for (auto& pin : pins(inst))
+        {
+            auto pin_net = net(pin);
+            if (pin_net)
+            {
+                journalNet(pin_net);
+                journal(JournalOp::Disconnect, pin, pin_net);
+            }
+        }
+        auto         db_inst = network()->staToDb(inst);
+        JournalEntry entry   = JournalEntry();
+        entry.op             = JournalOp::DeleteInstance;
+        entry.inst           = inst;
+        entry.cell           = libraryCell(inst);
+        entry.name           = name(inst);
+        entry.orient         = db_inst->getOrient().getValue();
+        entry.flag           = isPlaced(inst);
+        db_inst->getOrigin(entry.x, entry.y);
+        journal_.push_back(std::move(entry));
+    }
+    eraseIds(inst);
+    if (!timing_edit_pins_.empty())
+    {
+        for (auto& pin : pins(inst))
+        {
+            timing_edit_pins_.erase(pin);
+        }
+    }
     sta_->deleteInstance(inst);
 }
+void
+DatabaseHandler::eraseIds(Net* net) const
+{
+    std::lock_guard<std::mutex> lock(clock_nets_mutex_);
+    clock_nets_.erase(id(net));
+}
+void
+DatabaseHandler::eraseIds(Instance* inst) const
+{
+    // The driver index is the only table keyed by the pin IDs
+    indexDriverPins(inst, true);
+}
 int
 DatabaseHandler::disconnectAll(Net* net) const
 {
     int count = 0;
+    driver_order_valid_ = false;
+    journalNet(net);
     for (auto& pin : pins(net))
     {
+        if (journaling())
+        {
+            journal(JournalOp::Disconnect, pin, net);
+        }
         sta_->disconnectPin(pin);
         count++;
     }
@@ -2353,12 +2771,28 @@ DatabaseHandler::connect(Net* net, InstanceTerm* term) const
 {
     auto inst      = network()->instance(term);
     auto term_port = network()->port(term);
+    journalNet(net);
     sta_->connectPin(inst, term_port, net);
+    driver_order_valid_ = false;
+    if (journaling())
+    {
+        journal(JournalOp::Connect, term, net);
+    }
 }
 
 void
 DatabaseHandler::disconnect(InstanceTerm* term) const
 {
+    driver_order_valid_ = false;
+    if (journaling())
+    {
+        auto term_net = net(term);
+        if (term_net)
+        {
+            journalNet(term_net);
+            journal(JournalOp::Disconnect, term, term_net);
+        }
+    }
     sta_->disconnectPin(term);
 }
 
@@ -2376,13 +2810,25 @@ DatabaseHandler::swapPins(InstanceTerm* first, InstanceTerm* second)
         calculateParasitics(first_net);
         calculateParasitics(second_net);
     }
-    resetDelays(first);
-    resetDelays(second);
+    touchTiming(first);
+    touchTiming(second);
 }
 Instance*
 DatabaseHandler::createInstance(const char* inst_name, LibraryCell* cell)
 {
-    return sta_->makeInstance(inst_name, cell, network()->topInstance());
+    auto inst = sta_->makeInstance(inst_name, cell, network()->topInstance());
+    if (inst)
+    {
+        indexDriverPins(inst, false);
+        if (journaling())
+        {
+            JournalEntry entry = JournalEntry();
+            entry.op           = JournalOp::CreateInstance;
+            entry.inst         = inst;
+            journal_.push_back(std::move(entry));
+        }
+    }
+    return inst;
 }
 
 void
@@ -2401,6 +2847,7 @@ DatabaseHandler::createClock(const char*             clock_name,
     const char* comment = "";
     sta_->makeClock(clock_name, pin_set, false, period, waveform,
                     const_cast<char*>(comment));
+    invalidateClockNets();
 }
 void
 DatabaseHandler::setMaximumFanout(int max_fanout)
@@ -2425,6 +2872,18 @@ Net*
 DatabaseHandler::createNet(const char* net_name)
 {
     auto net = sta_->makeNet(net_name, network()->topInstance());
+    if (net)
+    {
+        // The database reuses the IDs of the deleted nets
+        setClock(net, false);
+        if (journaling())
+        {
+            JournalEntry entry = JournalEntry();
+            entry.op           = JournalOp::CreateNet;
+            entry.net          = net;
+            journal_.push_back(std::move(entry));
+        }
+    }
     return net;
 }
 float
@@ -2462,12 +2921,25 @@ DatabaseHandler::capacitancePerMicron() const
 void
 DatabaseHandler::connect(Net* net, Instance* inst, LibraryTerm* port) const
 {
+    driver_order_valid_ = false;
+    journalNet(net);
     sta_->connectPin(inst, port, net);
+    if (journaling())
+    {
+        journal(JournalOp::Connect, network()->findPin(inst, port->name()),
+                net);
+    }
 }
 void
 DatabaseHandler::connect(Net* net, Instance* inst, Port* port) const
 {
+    driver_order_valid_ = false;
+    journalNet(net);
     sta_->connectPin(inst, port, net);
+    if (journaling())
+    {
+        journal(JournalOp::Connect, network()->findPin(inst, port), net);
+    }
 }
 
 std::vector<Net*>
@@ -2507,6 +2979,7 @@ DatabaseHandler::setDontUse(std::vector<std::string>& cell_names)
             dont_use_.insert(cell);
         }
     }
+    characterization_key_valid_ = false;
 }
 
 std::string
@@ -2618,6 +3091,34 @@ DatabaseHandler::top() const
 
 DatabaseHandler::~DatabaseHandler()
 {
+    releaseThreadDelayCalculators();
+}
+sta::ArcDelayCalc*
+DatabaseHandler::arcDelayCalc() const
+{
+    if (std::this_thread::get_id() == main_thread_)
+    {
+        return sta_->arcDelayCalc();
+    }
+    // The STA calculators keep the state of the last evaluated arc, each
+    // worker thread gets its own copy.
+    std::lock_guard<std::mutex> lock(delay_calc_mutex_);
+    auto& calc = thread_delay_calcs_[std::this_thread::get_id()];
+    if (!calc)
+    {
+        calc = sta_->arcDelayCalc()->copy();
+    }
+    return calc;
+}
+void
+DatabaseHandler::releaseThreadDelayCalculators()
+{
+    std::lock_guard<std::mutex> lock(delay_calc_mutex_);
+    for (auto& thread_calc : thread_delay_calcs_)
+    {
+        delete thread_calc.second;
+    }
+    thread_delay_calcs_.clear();
 }
 void
 DatabaseHandler::clear()
@@ -2633,6 +3134,8 @@ DatabaseHandler::network() const
 DatabaseSta*
 DatabaseHandler::sta() const
 {
+    // Callers query the timing through the returned STA
+    flushParasitics();
     return sta_;
 }
 float
@@ -2714,10 +3217,15 @@ DatabaseHandler::isBuffer(LibraryCell* cell) const
 bool
 DatabaseHandler::isInverter(LibraryCell* cell) const
 {
-    auto out_pins = libraryOutputPins(cell);
-    return isSingleOutputCombinational(cell) && out_pins[0]->function() &&
-           out_pins[0]->function()->op() == sta::FuncExpr::op_not &&
-           libraryInputPins(cell).size() == 1;
+    if (!cell)
+    {
+        return false;
+    }
+    LibraryTerm* out_pin = nullptr;
+    return libraryPinCount(cell, true, &out_pin) == 1 &&
+           isCombinational(cell) && out_pin->function() &&
+           out_pin->function()->op() == sta::FuncExpr::op_not &&
+           libraryPinCount(cell, false) == 1;
 }
 void
 DatabaseHandler::replaceInstance(Instance* inst, LibraryCell* cell)
@@ -2725,12 +3233,16 @@ DatabaseHandler::replaceInstance(Instance* inst, LibraryCell* cell)
     bool both_inv  = isInverter(libraryCell(inst)) && isInverter(cell);
     bool both_buff = isBuffer(libraryCell(inst)) && isBuffer(cell);
 
+    std::vector<InstanceTerm*> in_pins;
     if (!both_inv && !both_buff && isSingleOutputCombinational(inst) &&
-        isSingleOutputCombinational(cell) && inputPins(inst).size() == 1 &&
-        libraryInputPins(cell).size() == 1)
+        isSingleOutputCombinational(cell))
+    {
+        inputPins(inst, in_pins);
+    }
+    if (in_pins.size() == 1 && libraryPinCount(cell, false) == 1)
     {
         // Manually replace inverters/buffers
-        auto in_pin     = inputPins(inst)[0];
+        auto in_pin     = in_pins[0];
         auto out_pin    = outputPins(inst)[0];
         auto input_net  = net(in_pin);
         auto output_net = net(out_pin);
@@ -2750,16 +3262,32 @@ DatabaseHandler::replaceInstance(Instance* inst, LibraryCell* cell)
     }
     else
     {
-        auto current_name = name(cell);
-        auto db_lib_cell  = db_->findMaster(current_name.c_str());
-        if (db_lib_cell)
+        replaceCell(inst, cell);
+    }
+}
+void
+DatabaseHandler::replaceCell(Instance* inst, LibraryCell* cell)
+{
+    auto db_lib_cell = db_->findMaster(name(cell).c_str());
+    if (!db_lib_cell)
+    {
+        return;
+    }
+    if (journaling())
+    {
+        JournalEntry entry = JournalEntry();
+        entry.op           = JournalOp::ReplaceCell;
+        entry.inst         = inst;
+        entry.cell         = libraryCell(inst);
+        journal_.push_back(std::move(entry));
+        for (auto& pin : pins(inst))
         {
-            auto db_inst     = network()->staToDb(inst);
-            auto db_inst_lib = db_inst->getMaster();
-            auto sta_cell    = network()->dbToSta(db_lib_cell);
-            sta_->replaceCell(inst, sta_cell);
+            journalNet(net(pin));
         }
     }
+    indexDriverPins(inst, true);
+    sta_->replaceCell(inst, network()->dbToSta(db_lib_cell));
+    indexDriverPins(inst, false);
 }
 
 bool
@@ -2769,9 +3297,7 @@ DatabaseHandler::isSingleOutputCombinational(LibraryCell* cell) const
     {
         return false;
     }
-    auto output_pins = libraryOutputPins(cell);
-
-    return (output_pins.size() == 1 && isCombinational(cell));
+    return (libraryPinCount(cell, true) == 1 && isCombinational(cell));
 }
 bool
 DatabaseHandler::isCombinational(Instance* inst) const
@@ -2830,7 +3356,8 @@ DatabaseHandler::setWireRC(ParasticsCallback res_per_micron,
 void
 DatabaseHandler::setDontUseCallback(DontUseCallback dont_use_callback)
 {
-    dont_use_callback_ = dont_use_callback;
+    dont_use_callback_          = dont_use_callback;
+    characterization_key_valid_ = false;
 }
 void
 DatabaseHandler::setComputeParasiticsCallback(
@@ -2878,6 +3405,7 @@ DatabaseHandler::isTriState(LibraryTerm* term) const
 float
 DatabaseHandler::capacitanceLimit(InstanceTerm* term) const
 {
+    flushParasitics();
     const sta::Corner*   corner;
     const sta::RiseFall* rf;
     float                cap, limit, diff;
@@ -2897,6 +3425,7 @@ bool
 DatabaseHandler::violatesMaximumCapacitance(InstanceTerm* term, float load_cap,
                                             float limit_scale_factor)
 {
+    flushParasitics();
     const sta::Corner*   corner;
     const sta::RiseFall* rf;
     float                cap, limit, ignore;
@@ -2916,6 +3445,7 @@ bool
 DatabaseHandler::violatesMaximumTransition(InstanceTerm* term,
                                            float         limit_scale_factor)
 {
+    flushParasitics();
     const sta::Corner*   corner;
     const sta::RiseFall* rf;
     float                slew, limit, ignore;
@@ -2959,11 +3489,15 @@ DatabaseHandler::hasElectricalViolation(InstanceTerm* pin,
                                         float         trans_sacle_factor)
 {
     auto pin_net   = net(pin);
-    auto net_pins  = pins(pin_net);
     bool vio_trans = false;
     bool vio_cap   = false;
-    for (auto connected_pin : net_pins)
+    for (auto iterm : network()->staToDb(pin_net)->getITerms())
     {
+        if (!isSignalTerm(iterm))
+        {
+            continue;
+        }
+        InstanceTerm* connected_pin = network()->dbToSta(iterm);
         if (violatesMaximumTransition(connected_pin, trans_sacle_factor))
         {
             vio_trans = true;
@@ -3002,6 +3536,7 @@ DatabaseHandler::hasElectricalViolation(InstanceTerm* pin,
 std::vector<InstanceTerm*>
 DatabaseHandler::maximumTransitionViolations(float limit_scale_factor)
 {
+    flushParasitics();
     auto vio_pins = sta_->pinSlewLimitViolations(corner_, sta::MinMax::max());
     slew_limits_initialized_ = true;
     return std::vector<InstanceTerm*>(vio_pins->begin(), vio_pins->end());
@@ -3009,6 +3544,7 @@ DatabaseHandler::maximumTransitionViolations(float limit_scale_factor)
 std::vector<InstanceTerm*>
 DatabaseHandler::maximumCapacitanceViolations(float limit_scale_factor)
 {
+    flushParasitics();
     auto vio_pins =
         sta_->pinCapacitanceLimitViolations(corner_, sta::MinMax::max());
     capacitance_limits_initialized_ = true;
@@ -3073,15 +3609,192 @@ DatabaseHandler::resetCache()
     slew_limits_initialized_        = false;
     capacitance_limits_initialized_ = false;
     fanout_limits_initialized_      = false;
+    characterization_key_valid_     = false;
     target_load_map_.clear();
+    commutative_classes_.clear();
+    {
+        std::lock_guard<std::mutex> lock(compiled_functions_mutex_);
+        compiled_functions_.clear();
+    }
+    invalidateClockNets();
+    {
+        std::lock_guard<std::mutex> lock(compiled_arcs_mutex_);
+        extra_compiled_arcs_.clear();
+    }
+    library_term_ids_.clear();
+    compiled_arcs_.clear();
+    for (auto lib : allLibs())
+    {
+        compileArcs(lib);
+    }
     resetLibraryMapping();
 }
 void
 DatabaseHandler::findTargetLoads()
 {
+    if (loadTargetLoads())
+    {
+        has_target_loads_ = true;
+        return;
+    }
     auto all_libs = allLibs();
     findTargetLoads(&all_libs);
     has_target_loads_ = true;
+
+    CharacterizationCache* cache = characterizationCache();
+    if (cache)
+    {
+        // Target slews followed by the target load of each cell
+        std::vector<std::string> cells;
+        std::vector<float>       values = {
+            target_slews_[sta::RiseFall::riseIndex()],
+            target_slews_[sta::RiseFall::fallIndex()]};
+        for (auto& lib : all_libs)
+        {
+            sta::LibertyCellIterator cell_iter(lib);
+            while (cell_iter.hasNext())
+            {
+                auto cell = cell_iter.next();
+                cells.push_back(characterizationName(cell));
+                values.push_back(target_load_map_.value(id(cell)));
+            }
+        }
+        cache->insert("target_loads", cells, values);
+        saveCharacterizationCache();
+    }
+}
+bool
+DatabaseHandler::loadTargetLoads()
+{
+    CharacterizationCache*    cache = characterizationCache();
+    std::vector<std::string>  names;
+    std::vector<float>        values;
+    std::vector<LibraryCell*> cells;
+    if (!cache || !cache->find("target_loads", names, values) ||
+        values.size() != names.size() + 2 ||
+        !characterizationCells(names, cells))
+    {
+        return false;
+    }
+    target_slews_[sta::RiseFall::riseIndex()] = values[0];
+    target_slews_[sta::RiseFall::fallIndex()] = values[1];
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        target_load_map_[id(cells[i])] = values[i + 2];
+    }
+    return true;
+}
+
+CharacterizationCache*
+DatabaseHandler::characterizationCache()
+{
+    std::lock_guard<std::mutex> lock(characterization_mutex_);
+    if (characterization_dir_.empty())
+    {
+        return nullptr;
+    }
+    auto libs = allLibs();
+    // The delays are characterized at the corner and operating conditions of
+    // the delay calculation
+    std::string conditions = corner_->name();
+    auto        op_cond    = dcalc_ap_->operatingConditions();
+    if (!op_cond)
+    {
+        op_cond = sta_->sdc()->operatingConditions(min_max_);
+    }
+    if (op_cond)
+    {
+        conditions += " " + std::string(op_cond->name()) + " " +
+                      std::to_string(op_cond->process()) + " " +
+                      std::to_string(op_cond->voltage()) + " " +
+                      std::to_string(op_cond->temperature());
+    }
+    if (characterization_key_valid_ && libs == characterization_libs_ &&
+        conditions == characterization_conditions_)
+    {
+        return &characterization_cache_;
+    }
+    // The characterization depends on the library contents, on the
+    // don't-use cells and on the conditions
+    uint64_t key = CharacterizationCache::hash(
+        std::to_string(CharacterizationCache::version));
+    key = CharacterizationCache::hash(conditions, key);
+    for (auto& lib : libs)
+    {
+        if (!lib->filename() ||
+            !CharacterizationCache::hashFile(lib->filename(), key))
+        {
+            PSN_LOG_WARN("Cannot read the library {}, the characterization "
+                         "cache is not used",
+                         lib->name());
+            return nullptr;
+        }
+        sta::LibertyCellIterator cell_iter(lib);
+        while (cell_iter.hasNext())
+        {
+            auto cell = cell_iter.next();
+            if (dontUse(cell))
+            {
+                key = CharacterizationCache::hash(characterizationName(cell),
+                                                  key);
+            }
+        }
+    }
+    char file_name[32];
+    std::snprintf(file_name, sizeof(file_name), "psn_%016llx.cache",
+                  static_cast<unsigned long long>(key));
+    characterization_path_ =
+        FileUtils::joinPath(characterization_dir_, file_name);
+    if (characterization_cache_.load(characterization_path_, key))
+    {
+        PSN_LOG_INFO("Loaded {} characterization records from {}",
+                     characterization_cache_.size(), characterization_path_);
+    }
+    characterization_libs_       = libs;
+    characterization_conditions_ = conditions;
+    characterization_key_valid_  = true;
+    return &characterization_cache_;
+}
+void
+DatabaseHandler::saveCharacterizationCache()
+{
+    if (!characterization_cache_.save(characterization_path_))
+    {
+        PSN_LOG_WARN("Failed to write the characterization cache {}",
+                     characterization_path_);
+    }
+}
+std::string
+DatabaseHandler::characterizationName(LibraryCell* cell) const
+{
+    return std::string(cell->libertyLibrary()->name()) + "/" + cell->name();
+}
+LibraryCell*
+DatabaseHandler::characterizationCell(const std::string& name) const
+{
+    size_t separator = name.find('/');
+    if (separator == std::string::npos)
+    {
+        return nullptr;
+    }
+    auto lib = network()->findLiberty(name.substr(0, separator).c_str());
+    return lib ? lib->findLibertyCell(name.c_str() + separator + 1) : nullptr;
+}
+bool
+DatabaseHandler::characterizationCells(const std::vector<std::string>& names,
+                                       std::vector<LibraryCell*>& cells) const
+{
+    cells.clear();
+    for (auto& name : names)
+    {
+        auto cell = characterizationCell(name);
+        if (!cell)
+        {
+            return false;
+        }
+        cells.push_back(cell);
+    }
+    return true;
 }
 
 Vertex*
@@ -3102,7 +3815,91 @@ int
 DatabaseHandler::evaluateFunctionExpression(
     LibraryTerm* term, std::unordered_map<LibraryTerm*, int>& inputs) const
 {
-    return evaluateFunctionExpression(term->function(), inputs);
+    auto& compiled = compiledFunction(term);
+    if (!compiled.valid())
+    {
+        return term->function()
+                   ? evaluateFunctionExpression(term->function(), inputs)
+                   : -1;
+    }
+    uint64_t input_bits = 0;
+    for (size_t i = 0; i < compiled.inputs().size(); i++)
+    {
+        if (!((compiled.usedInputs() >> i) & 1))
+        {
+            continue;
+        }
+        auto input_itr = inputs.find(compiled.inputs()[i]);
+        if (input_itr == inputs.end())
+        {
+            return -1;
+        }
+        if (input_itr->second)
+        {
+            input_bits |= uint64_t(1) << i;
+        }
+    }
+    return compiled.evaluate(input_bits);
+}
+const CompiledFunction&
+DatabaseHandler::compiledFunction(LibraryTerm* term) const
+{
+    std::lock_guard<std::mutex> lock(compiled_functions_mutex_);
+    auto&                       compiled = compiled_functions_[term];
+    if (!compiled)
+    {
+        std::vector<LibraryTerm*> input_pins;
+        libraryInputPins(term->libertyCell(), input_pins);
+        compiled.reset(new CompiledFunction(input_pins));
+        if (term->function())
+        {
+            compileFunction(term->function(), *compiled);
+        }
+        else
+        {
+            compiled->invalidate();
+        }
+    }
+    return *compiled;
+}
+void
+DatabaseHandler::compileFunction(sta::FuncExpr*    func,
+                                 CompiledFunction& compiled) const
+{
+    switch (func->op())
+    {
+    case sta::FuncExpr::op_port:
+        compiled.pushInput(compiled.inputIndex(func->port()));
+        break;
+    case sta::FuncExpr::op_not:
+        compileFunction(func->left(), compiled);
+        compiled.pushOperation(CompiledFunction::Not);
+        break;
+    case sta::FuncExpr::op_or:
+        compileFunction(func->left(), compiled);
+        compileFunction(func->right(), compiled);
+        compiled.pushOperation(CompiledFunction::Or);
+        break;
+    case sta::FuncExpr::op_and:
+        compileFunction(func->left(), compiled);
+        compileFunction(func->right(), compiled);
+        compiled.pushOperation(CompiledFunction::And);
+        break;
+    case sta::FuncExpr::op_xor:
+        compileFunction(func->left(), compiled);
+        compileFunction(func->right(), compiled);
+        compiled.pushOperation(CompiledFunction::Xor);
+        break;
+    case sta::FuncExpr::op_one:
+        compiled.pushConstant(true);
+        break;
+    case sta::FuncExpr::op_zero:
+        compiled.pushConstant(false);
+        break;
+    default:
+        compiled.invalidate();
+        break;
+    }
 }
 int
 DatabaseHandler::evaluateFunctionExpression(
@@ -3176,86 +3973,207 @@ DatabaseHandler::evaluateFunctionExpression(
 float
 DatabaseHandler::bufferChainDelayPenalty(float load_cap)
 {
-    if (!has_buffer_inverter_seq_)
     {
-        computeBuffersDelayPenalty();
+        std::lock_guard<std::mutex> lock(penalty_mutex_);
+        if (!has_buffer_inverter_seq_)
+        {
+            computeBuffersDelayPenalty();
+        }
     }
 
-    if (!buffer_inverter_seq_.size())
+    if (!buffer_inverter_seq_.size() ||
+        bufferInputCapacitance(buffer_inverter_seq_[0]) >= load_cap)
     {
         return 0.0;
     }
-
-    if (!penalty_cache_.count(load_cap))
+    float position = penalty_curve_.size() < 2
+                         ? sta::INF
+                         : (load_cap - penalty_curve_start_) /
+                               penalty_curve_step_;
+    if (position > penalty_curve_.size() - 1)
     {
-        auto smallest_buff = buffer_inverter_seq_[0];
-        if (bufferInputCapacitance(smallest_buff) >= load_cap)
-        {
-            penalty_cache_[load_cap] = 0.0;
-            return 0.0;
-        }
-        else
+        // Loads beyond the curve are computed exactly
+        std::vector<float> penalties;
+        bufferChainDelayPenalties(std::vector<float>(1, load_cap), penalties);
+        return penalties[0];
+    }
+    size_t index = std::min(static_cast<size_t>(position),
+                            penalty_curve_.size() - 2);
+    float  t     = position - index;
+    return penalty_curve_[index] +
+           t * (penalty_curve_[index + 1] - penalty_curve_[index]);
+}
+float
+DatabaseHandler::bufferChainDelayPenaltyError() const
+{
+    return penalty_curve_error_;
+}
+void
+DatabaseHandler::bufferChainDelayPenalties(const std::vector<float>& load_caps,
+                                           std::vector<float>&       penalties)
+{
+    penalties.assign(load_caps.size(), sta::INF);
+    std::vector<float> delays(load_caps.size());
+    for (auto& buf : buffer_inverter_seq_)
+    {
+        bool  is_inverting = inverting_buffer_.count(buf) > 0;
+        float d_penalty    = is_inverting
+                              ? inverting_buffer_penalty_map_.value(id(buf))
+                              : buffer_penalty_map_.value(id(buf));
+        gateDelays(bufferOutputPin(buf), load_caps.data(), delays.data(),
+                   nullptr, load_caps.size());
+        for (size_t i = 0; i < load_caps.size(); i++)
         {
-            float        min_penalty = sta::INF;
-            LibraryCell* c;
-            for (auto& buf : buffer_inverter_seq_)
-            {
-                bool  is_inverting = inverting_buffer_.count(buf) > 0;
-                float d_penalty    = is_inverting
-                                      ? inverting_buffer_penalty_map_[buf]
-                                      : buffer_penalty_map_[buf];
-                auto  out_pin = bufferOutputPin(buf);
-                float delay   = gateDelay(out_pin, load_cap);
-                float penalty = delay + d_penalty;
-                if (penalty < min_penalty)
-                {
-                    min_penalty = penalty;
-                    c           = buf;
-                }
-            }
-            penalty_cache_[load_cap] = min_penalty;
-            return min_penalty;
+            penalties[i] = std::min(penalties[i], delays[i] + d_penalty);
         }
     }
-    return penalty_cache_[load_cap];
 }
-
 void
-DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
-{
-    // TODO Support include buffer slews
-    auto all_libs = allLibs();
-    buffer_inverter_seq_.clear();
-    inverting_buffer_.clear();
-    non_inverting_buffer_.clear();
-
-    for (auto& lib : all_libs)
+DatabaseHandler::computeBuffersDelayPenaltyCurve()
+{
+    penalty_curve_.clear();
+    penalty_curve_error_ = 0.0;
+    // The curve spans the input capacitances of the library cells, it starts
+    // at the smallest buffer where the penalty becomes positive
+    float start = bufferInputCapacitance(buffer_inverter_seq_[0]);
+    float end   = start;
+    for (auto& lib : allLibs())
     {
-        auto buff_types = *lib->buffers();
-        for (auto& b :
-             std::vector<LibraryCell*>(buff_types.begin(), buff_types.end()))
+        sta::LibertyCellIterator cell_iter(lib);
+        while (cell_iter.hasNext())
         {
-            if (!dontUse(b))
-            {
-                non_inverting_buffer_.insert(b);
-                buffer_inverter_seq_.push_back(b);
-            }
+            end = std::max(end, largestInputCapacitance(cell_iter.next()));
         }
     }
-    if (include_inverting)
+    if (end <= start)
     {
-        auto all_inverters = inverterCells();
-        for (auto& inv : all_inverters)
+        return;
+    }
+    const int          sample_count = 512;
+    const int          error_steps  = 4;
+    std::vector<float> caps(sample_count);
+    penalty_curve_start_ = start;
+    penalty_curve_step_  = (end - start) / (sample_count - 1);
+    for (int i = 0; i < sample_count; i++)
+    {
+        caps[i] = start + i * penalty_curve_step_;
+    }
+    bufferChainDelayPenalties(caps, penalty_curve_);
+
+    // Measure the interpolation error inside each sample interval
+    std::vector<float> error_caps, exact;
+    for (int i = 0; i < sample_count - 1; i++)
+    {
+        for (int j = 1; j < error_steps; j++)
         {
-            if (!dontUse(inv))
-            {
-                inverting_buffer_.insert(inv);
-                buffer_inverter_seq_.push_back(inv);
-            }
+            error_caps.push_back(caps[i] +
+                                 j * penalty_curve_step_ / error_steps);
         }
     }
-
-    std::sort(buffer_inverter_seq_.begin(), buffer_inverter_seq_.end(),
+    bufferChainDelayPenalties(error_caps, exact);
+    for (size_t i = 0; i < error_caps.size(); i++)
+    {
+        size_t index = i / (error_steps - 1);
+        float  t     = float((i % (error_steps - 1)) + 1) / error_steps;
+        float  value = penalty_curve_[index] +
+                      t * (penalty_curve_[index + 1] - penalty_curve_[index]);
+        penalty_curve_error_ =
+            std::max(penalty_curve_error_, std::abs(value - exact[i]));
+    }
+    PSN_LOG_INFO("Buffer chain penalty curve: {} samples up to {}, maximum "
+                 "interpolation error {}",
+                 sample_count, end, penalty_curve_error_);
+}
+
+bool
+DatabaseHandler::loadBuffersDelayPenalty(bool include_inverting)
+{
+    CharacterizationCache*    cache = characterizationCache();
+    std::vector<std::string>  names;
+    std::vector<float>        values;
+    std::vector<LibraryCell*> cells;
+    if (!cache ||
+        !cache->find("buffer_penalty/" + std::to_string(include_inverting),
+                     names, values) ||
+        values.size() < 3 * names.size() + 3 ||
+        !characterizationCells(names, cells))
+    {
+        return false;
+    }
+    buffer_inverter_seq_ = cells;
+    inverting_buffer_.clear();
+    non_inverting_buffer_.clear();
+    buffer_penalty_map_.clear();
+    inverting_buffer_penalty_map_.clear();
+    for (size_t i = 0; i < cells.size(); i++)
+    {
+        bool is_inverting = values[3 * i] != 0.0;
+        if (is_inverting)
+        {
+            inverting_buffer_.insert(cells[i]);
+        }
+        else
+        {
+            non_inverting_buffer_.insert(cells[i]);
+        }
+        if (!is_inverting || !i)
+        {
+            buffer_penalty_map_[id(cells[i])] = values[3 * i + 1];
+        }
+        if (is_inverting || !i)
+        {
+            inverting_buffer_penalty_map_[id(cells[i])] = values[3 * i + 2];
+        }
+    }
+    auto curve           = values.begin() + 3 * cells.size();
+    penalty_curve_start_ = curve[0];
+    penalty_curve_step_  = curve[1];
+    penalty_curve_error_ = curve[2];
+    penalty_curve_.assign(curve + 3, values.end());
+    has_buffer_inverter_seq_ = true;
+    return true;
+}
+
+void
+DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
+{
+    if (loadBuffersDelayPenalty(include_inverting))
+    {
+        return;
+    }
+    // TODO Support include buffer slews
+    auto all_libs = allLibs();
+    buffer_inverter_seq_.clear();
+    inverting_buffer_.clear();
+    non_inverting_buffer_.clear();
+
+    for (auto& lib : all_libs)
+    {
+        auto buff_types = *lib->buffers();
+        for (auto& b :
+             std::vector<LibraryCell*>(buff_types.begin(), buff_types.end()))
+        {
+            if (!dontUse(b))
+            {
+                non_inverting_buffer_.insert(b);
+                buffer_inverter_seq_.push_back(b);
+            }
+        }
+    }
+    if (include_inverting)
+    {
+        auto all_inverters = inverterCells();
+        for (auto& inv : all_inverters)
+        {
+            if (!dontUse(inv))
+            {
+                inverting_buffer_.insert(inv);
+                buffer_inverter_seq_.push_back(inv);
+            }
+        }
+    }
+
+    std::sort(buffer_inverter_seq_.begin(), buffer_inverter_seq_.end(),
               [=](LibraryCell* b1, LibraryCell* b2) -> bool {
                   return bufferInputCapacitance(b1) <
                          bufferInputCapacitance(b2);
@@ -3263,15 +4181,16 @@ DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
     has_buffer_inverter_seq_ = true;
     buffer_penalty_map_.clear();
     inverting_buffer_penalty_map_.clear();
-    penalty_cache_.clear();
+    penalty_curve_.clear();
+    penalty_curve_error_ = 0.0;
     if (!buffer_inverter_seq_.size())
     {
         return;
     }
     auto first_cell = buffer_inverter_seq_[0];
-    buffer_penalty_map_[first_cell] =
+    buffer_penalty_map_[id(first_cell)] =
         inverting_buffer_.count(first_cell) ? sta::INF : 0;
-    inverting_buffer_penalty_map_[first_cell] =
+    inverting_buffer_penalty_map_[id(first_cell)] =
         inverting_buffer_.count(first_cell) ? 0 : sta::INF;
 
     for (size_t i = 1; i < buffer_inverter_seq_.size(); i++)
@@ -3290,8 +4209,9 @@ DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
 
             float d_penalty =
                 is_inverting
-                    ? inverting_buffer_penalty_map_[buffer_inverter_seq_[j]]
-                    : buffer_penalty_map_[buffer_inverter_seq_[j]];
+                    ? inverting_buffer_penalty_map_.value(
+                          id(buffer_inverter_seq_[j]))
+                    : buffer_penalty_map_.value(id(buffer_inverter_seq_[j]));
 
             float penalty = delay + d_penalty;
             if (penalty < min_penalty)
@@ -3302,14 +4222,39 @@ DatabaseHandler::computeBuffersDelayPenalty(bool include_inverting)
         }
         if (is_sink_inverting)
         {
-            inverting_buffer_penalty_map_[buffer_inverter_seq_[i]] =
+            inverting_buffer_penalty_map_[id(buffer_inverter_seq_[i])] =
                 min_penalty;
         }
         else
         {
-            buffer_penalty_map_[buffer_inverter_seq_[i]] = min_penalty;
+            buffer_penalty_map_[id(buffer_inverter_seq_[i])] = min_penalty;
         }
     }
+    computeBuffersDelayPenaltyCurve();
+
+    CharacterizationCache* cache = characterizationCache();
+    if (cache)
+    {
+        // Inverting flag and both penalties of each cell followed by the
+        // penalty curve
+        std::vector<std::string> cells;
+        std::vector<float>       values;
+        for (auto& cell : buffer_inverter_seq_)
+        {
+            cells.push_back(characterizationName(cell));
+            values.push_back(inverting_buffer_.count(cell) ? 1.0 : 0.0);
+            values.push_back(buffer_penalty_map_.value(id(cell)));
+            values.push_back(inverting_buffer_penalty_map_.value(id(cell)));
+        }
+        values.push_back(penalty_curve_start_);
+        values.push_back(penalty_curve_step_);
+        values.push_back(penalty_curve_error_);
+        values.insert(values.end(), penalty_curve_.begin(),
+                      penalty_curve_.end());
+        cache->insert("buffer_penalty/" + std::to_string(include_inverting),
+                      cells, values);
+        saveCharacterizationCache();
+    }
 }
 InstanceTerm*
 DatabaseHandler::largestLoadCapacitancePin(Instance* cell)
@@ -3501,40 +4446,35 @@ DatabaseHandler::buildLibraryMappings(int                        max_length,
                 auto starting_input_pins  = libraryInputPins(random_cell);
                 auto starting_output_pins = libraryOutputPins(random_cell);
                 int  table                = 0;
-                sta::FuncExpr* starting_output_func =
-                    starting_output_pins[0]->function();
-                int prev_output;
-                for (int i = 0; i < std::pow(2, starting_input_pins.size());
-                     ++i)
+
+                auto& starting_function =
+                    compiledFunction(starting_output_pins[0]);
+                std::vector<const CompiledFunction*> node_functions;
+                for (size_t m = 1; m < chain.size(); m++)
+                {
+                    auto node_random_cell =
+                        *(function_to_cell_[chain[m]].begin());
+                    node_functions.push_back(&compiledFunction(
+                        libraryOutputPins(node_random_cell)[0]));
+                }
+                size_t input_count = starting_input_pins.size();
+                int    prev_output;
+                for (size_t i = 0; i < (size_t(1) << input_count); ++i)
                 {
-                    std::unordered_map<LibraryTerm*, int> sim_vals;
-                    std::bitset<64>                       input_bits(i);
-                    for (size_t j = 0; j < starting_input_pins.size(); j++)
+                    // The first input pin takes the most significant bit
+                    uint64_t input_bits = 0;
+                    for (size_t j = 0; j < input_count; j++)
                     {
-                        sim_vals[starting_input_pins[j]] =
-                            input_bits.test(starting_input_pins.size() - j - 1);
+                        size_t bit = input_count - j - 1;
+                        input_bits |= uint64_t((i >> bit) & 1) << j;
                     }
-                    prev_output = evaluateFunctionExpression(
-                        starting_output_func, sim_vals);
-                    for (size_t m = 1; m < chain.size(); m++)
+                    prev_output = starting_function.evaluate(input_bits);
+                    for (auto node_function : node_functions)
                     {
-                        sim_vals.clear();
-                        auto node_table_id = chain[m];
-                        auto node_random_cell =
-                            *(function_to_cell_[node_table_id].begin());
-
-                        auto node_input_pins =
-                            libraryInputPins(node_random_cell);
-                        auto node_output_pins =
-                            libraryOutputPins(node_random_cell);
-                        sta::FuncExpr* node_output_func =
-                            node_output_pins[0]->function();
-                        for (auto& in_pin : node_input_pins)
-                        {
-                            sim_vals[in_pin] = prev_output;
-                        }
-                        prev_output = evaluateFunctionExpression(
-                            node_output_func, sim_vals);
+                        // All the node inputs are driven by the previous
+                        // output
+                        prev_output =
+                            node_function->evaluate(prev_output ? ~0ull : 0);
                     }
                     table |= prev_output << i;
                 }
@@ -3549,27 +4489,18 @@ DatabaseHandler::buildLibraryMappings(int                        max_length,
 
                             auto new_table_random_cell =
                                 *(function_to_cell_[new_table].begin());
-                            auto new_table_input_pins =
-                                libraryInputPins(new_table_random_cell);
                             auto new_table_output_pins =
                                 libraryOutputPins(new_table_random_cell);
-                            int            table = 0;
-                            sta::FuncExpr* new_table_output_func =
-                                new_table_output_pins[0]->function();
-                            std::unordered_map<LibraryTerm*, int> sim_vals;
+                            auto& new_table_function = compiledFunction(
+                                new_table_output_pins[0]);
 
                             int new_chain_table = 0;
-                            for (int i = 0;
-                                 i < std::pow(2, starting_input_pins.size());
+                            for (size_t i = 0; i < (size_t(1) << input_count);
                                  ++i)
                             {
-                                for (auto& in_pin : new_table_input_pins)
-                                {
-                                    sim_vals[in_pin] = table_bits.test(i);
-                                }
                                 new_chain_table |=
-                                    evaluateFunctionExpression(
-                                        new_table_output_func, sim_vals)
+                                    new_table_function.evaluate(
+                                        table_bits.test(i) ? ~0ull : 0)
                                     << i;
                             }
                             if (new_chain_table &&
@@ -3675,21 +4606,28 @@ DatabaseHandler::buildLibraryMappings(int                        max_length,
 int
 DatabaseHandler::computeTruthTable(LibraryCell* lib_cell)
 {
-    int            table       = 0;
-    auto           output_pins = libraryOutputPins(lib_cell);
-    auto           input_pins  = libraryInputPins(lib_cell);
-    auto           output_pin  = output_pins[0];
-    sta::FuncExpr* output_func = output_pin->function();
-    for (int i = 0; i < std::pow(2, input_pins.size()); ++i)
+    int                   table       = 0;
+    auto                  output_pins = libraryOutputPins(lib_cell);
+    auto&                 compiled    = compiledFunction(output_pins[0]);
+    std::vector<uint64_t> minterms;
+    if (!compiled.truthTable(minterms))
+    {
+        return -1;
+    }
+    // Entry i of the table gives the first input pin the most significant
+    // bit of i, the compiled minterms give it the least significant one. Only
+    // the entries fitting in the returned table are filled.
+    size_t input_count = compiled.inputs().size();
+    size_t entries     = std::min(size_t(1) << input_count, sizeof(table) * 8);
+    for (size_t i = 0; i < entries; ++i)
     {
-        std::unordered_map<LibraryTerm*, int> sim_vals;
-        std::bitset<64>                       input_bits(i);
-        for (size_t j = 0; j < input_pins.size(); j++)
+        size_t m = 0;
+        for (size_t j = 0; j < input_count; j++)
         {
-            sim_vals[input_pins[j]] =
-                input_bits.test(input_pins.size() - j - 1);
+            m |= ((i >> (input_count - j - 1)) & 1) << j;
         }
-        table |= evaluateFunctionExpression(output_func, sim_vals) << i;
+        unsigned bit = (minterms[m >> 6] >> (m & 63)) & 1;
+        table |= static_cast<int>(bit << i);
     }
     return table;
 }
@@ -3715,6 +4653,49 @@ DatabaseHandler::findTargetLoads(std::vector<Liberty*>* resize_libs)
         findTargetLoads(lib, target_slews_);
 }
 
+size_t
+DatabaseHandler::id(InstanceTerm* term) const
+{
+    odb::dbITerm* iterm;
+    odb::dbBTerm* bterm;
+    network()->staToDb(term, iterm, bterm);
+    // Instance and block terminals are interleaved in one ID space
+    if (iterm)
+    {
+        return 2 * static_cast<size_t>(iterm->getId());
+    }
+    return 2 * static_cast<size_t>(bterm->getId()) + 1;
+}
+size_t
+DatabaseHandler::id(Net* net) const
+{
+    return network()->staToDb(net)->getId();
+}
+size_t
+DatabaseHandler::id(Instance* inst) const
+{
+    return network()->staToDb(inst)->getId();
+}
+size_t
+DatabaseHandler::id(LibraryCell* cell)
+{
+    odb::dbMaster* master = network()->staToDb(cell);
+    if (master)
+    {
+        return 2 * static_cast<size_t>(master->getMasterId());
+    }
+    // Liberty cells without a physical master get their own odd IDs
+    std::lock_guard<std::mutex> lock(cell_ids_mutex_);
+    auto                        it = unmapped_cell_ids_.find(cell);
+    if (it != unmapped_cell_ids_.end())
+    {
+        return it->second;
+    }
+    size_t cell_id = 2 * unmapped_cell_ids_.size() + 1;
+    unmapped_cell_ids_[cell] = cell_id;
+    return cell_id;
+}
+
 float
 DatabaseHandler::targetLoad(LibraryCell* cell)
 {
@@ -3722,11 +4703,7 @@ DatabaseHandler::targetLoad(LibraryCell* cell)
     {
         findTargetLoads();
     }
-    if (target_load_map_.count(cell))
-    {
-        return target_load_map_[cell];
-    }
-    return 0.0;
+    return target_load_map_.value(id(cell));
 }
 
 float
@@ -3815,44 +4792,184 @@ DatabaseHandler::gateDelay(LibraryCell* lib_cell, InstanceTerm* to,
                            float in_slew, LibraryTerm* from, float* drvr_slew,
                            int rise_fall)
 {
-    sta::ArcDelay                        max = -sta::INF;
-    sta::LibertyCellTimingArcSetIterator itr(lib_cell);
-    while (itr.hasNext())
+    sta::ArcDelay max      = -sta::INF;
+    LibraryTerm*  out_port = libraryPin(to);
+    if (!out_port || out_port->libertyCell() != lib_cell)
+    {
+        return max;
+    }
+    float load_cap      = 0.0;
+    bool  load_computed = false;
+    for (auto& arc : compiledArcs(out_port))
     {
-        sta::TimingArcSet* arc_set = itr.next();
-        if (arc_set->to() == libraryPin(to))
+        if (!from || (from && arc.arc->from() == from))
         {
-            sta::TimingArcSetArcIterator arc_it(arc_set);
-            while (arc_it.hasNext())
+            if (rise_fall != -1 ||
+                (rise_fall == 1 && arc.out_rf == sta::RiseFall::riseIndex()) ||
+                (rise_fall == 0 && arc.out_rf == sta::RiseFall::fallIndex()))
             {
-                sta::TimingArc* arc = arc_it.next();
-                if (!from || (from && arc->from() == from))
+                // 1 is rising edge
+                // 0 is falling edge
+                if (!load_computed)
                 {
-                    if (rise_fall != -1 ||
-                        (rise_fall == 1 && arc->toTrans()->asRiseFall() ==
-                                               sta::RiseFall::rise()) ||
-                        (rise_fall == 0 &&
-                         arc->toTrans()->asRiseFall() == sta::RiseFall::fall()))
-                    {
-                        // 1 is rising edge
-                        // 0 is falling edge
-                        float         load_cap = loadCapacitance(to);
-                        sta::ArcDelay gate_delay;
-                        sta::Slew     tmp_slew;
-                        sta::Slew*    slew = drvr_slew ? drvr_slew : &tmp_slew;
-                        in_slew =
-                            target_slews_[arc->toTrans()->asRiseFall()->index()];
-                        sta_->arcDelayCalc()->gateDelay(
-                            lib_cell, arc, in_slew, load_cap, nullptr, 0.0,
-                            pvt_, dcalc_ap_, gate_delay, *slew);
-                        max = std::max(max, gate_delay);
-                    }
+                    load_cap      = loadCapacitance(to);
+                    load_computed = true;
                 }
+                float gate_delay, tmp_slew;
+                float* slew = drvr_slew ? drvr_slew : &tmp_slew;
+                in_slew     = target_slews_[arc.out_rf];
+                arcDelay(lib_cell, arc, in_slew, load_cap, gate_delay, *slew);
+                max = std::max(max, gate_delay);
             }
         }
     }
     return max;
 }
+std::vector<SizingCandidate>
+DatabaseHandler::evaluateSizes(Instance*                        inst,
+                               const std::vector<LibraryCell*>& cells)
+{
+    std::vector<SizingCandidate> candidates;
+    if (!libraryCell(inst))
+    {
+        return candidates;
+    }
+    flushParasitics();
+    auto path_ap  = corner_->findPathAnalysisPt(min_max_);
+    auto in_pins  = inputPins(inst);
+    auto out_pins = outputPins(inst);
+
+    // The fanin driver delays are re-evaluated with the input capacitance
+    // difference of each candidate
+    std::vector<LibraryTerm*> in_ports, fanin_ports;
+    std::vector<float>        in_caps, fanin_loads, fanin_delays;
+    // The pin timing does not change with the candidate, it is read once per
+    // pin and transition
+    std::vector<float> in_slews, in_arrivals, out_requireds;
+    for (auto& in_pin : in_pins)
+    {
+        auto in_vertex = vertex(in_pin);
+        for (auto rf : sta::RiseFall::range())
+        {
+            in_slews.push_back(
+                sta_->vertexSlew(in_vertex, rf, sta::MinMax::max()));
+            in_arrivals.push_back(sta_->vertexArrival(in_vertex, rf, path_ap));
+        }
+        auto  in_port    = libraryPin(in_pin);
+        auto  fanin_pin  = faninPin(in_pin);
+        auto  fanin_port = fanin_pin ? libraryPin(fanin_pin) : nullptr;
+        float fanin_load = fanin_port ? loadCapacitance(fanin_pin) : 0.0;
+        in_ports.push_back(in_port);
+        in_caps.push_back(pinCapacitance(in_port));
+        fanin_ports.push_back(fanin_port);
+        fanin_loads.push_back(fanin_load);
+        fanin_delays.push_back(
+            fanin_port ? gateDelay(fanin_port, fanin_load) : 0.0);
+    }
+    std::vector<LibraryTerm*> out_ports;
+    std::vector<float>        load_caps, slew_limits;
+    for (auto& out_pin : out_pins)
+    {
+        bool  exists;
+        float limit = pinSlewLimit(out_pin, &exists);
+        out_ports.push_back(libraryPin(out_pin));
+        load_caps.push_back(loadCapacitance(out_pin));
+        slew_limits.push_back(exists ? limit : sta::INF);
+        auto out_vertex = vertex(out_pin);
+        for (auto rf : sta::RiseFall::range())
+        {
+            out_requireds.push_back(
+                sta_->vertexRequired(out_vertex, rf, path_ap));
+        }
+    }
+
+    std::vector<float> added_delays(in_pins.size());
+    for (auto& cell : cells)
+    {
+        SizingCandidate candidate = {cell, -sta::INF, -sta::INF, 0.0,
+                                     sta::INF,  area(cell), true};
+        bool            matched   = true;
+        for (size_t i = 0; matched && i < in_pins.size(); i++)
+        {
+            auto port = libraryPin(cell, in_ports[i]->name());
+            matched   = port != nullptr;
+            if (port && fanin_ports[i])
+            {
+                float load = fanin_loads[i] - in_caps[i] + pinCapacitance(port);
+                added_delays[i] = gateDelay(fanin_ports[i], load) -
+                                  fanin_delays[i];
+                candidate.fanin_delay =
+                    std::max(candidate.fanin_delay, added_delays[i]);
+            }
+        }
+        for (size_t j = 0; matched && j < out_pins.size(); j++)
+        {
+            auto port = libraryPin(cell, out_ports[j]->name());
+            matched   = port != nullptr;
+            if (!port)
+            {
+                break;
+            }
+            float max_load = maxLoad(port);
+            if (max_load > 0.0 && load_caps[j] > max_load)
+            {
+                candidate.legal = false;
+            }
+            for (auto& arc : compiledArcs(port))
+            {
+                size_t i = 0;
+                while (i < in_ports.size() &&
+                       std::strcmp(in_ports[i]->name(),
+                                   arc.arc->from()->name()))
+                {
+                    i++;
+                }
+                if (i == in_ports.size())
+                {
+                    continue;
+                }
+                size_t in_index  = i * sta::RiseFall::index_count + arc.in_rf;
+                size_t out_index = j * sta::RiseFall::index_count + arc.out_rf;
+                float  delay, slew;
+                arcDelay(cell, arc, in_slews[in_index], load_caps[j], delay,
+                         slew);
+                candidate.delay = std::max(candidate.delay, delay);
+                candidate.slew  = std::max(candidate.slew, slew);
+
+                float arrival = in_arrivals[in_index];
+                float req     = out_requireds[out_index];
+                if (!sta::fuzzyInf(arrival) && !sta::fuzzyInf(req))
+                {
+                    candidate.slack =
+                        std::min(candidate.slack,
+                                 req - (arrival + added_delays[i] + delay));
+                }
+            }
+            if (candidate.slew > slew_limits[j])
+            {
+                candidate.legal = false;
+            }
+        }
+        if (matched)
+        {
+            candidates.push_back(candidate);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const SizingCandidate& a,
+                        const SizingCandidate& b) -> bool {
+                         if (a.legal != b.legal)
+                         {
+                             return a.legal;
+                         }
+                         if (a.slack != b.slack)
+                         {
+                             return a.slack > b.slack;
+                         }
+                         return a.area < b.area;
+                     });
+    return candidates;
+}
 void
 DatabaseHandler::findTargetLoads(Liberty* library, sta::Slew slews[])
 {
@@ -3892,7 +5009,7 @@ DatabaseHandler::findTargetLoad(LibraryCell* cell, sta::Slew slews[])
         }
     }
     float target_load = (arc_count > 0) ? target_load_sum / arc_count : 0.0;
-    target_load_map_[cell] = target_load;
+    target_load_map_[id(cell)] = target_load;
 }
 
 // Find the load capacitance that will cause the output slew
@@ -3929,7 +5046,20 @@ DatabaseHandler::findTargetLoad(LibraryCell* cell, sta::TimingArc* arc,
 std::set<Net*>
 DatabaseHandler::clockNets() const
 {
-    std::set<Net*>            nets;
+    std::set<Net*> clock_nets;
+    for (auto& net : nets())
+    {
+        if (isClock(net))
+        {
+            clock_nets.insert(net);
+        }
+    }
+    return clock_nets;
+}
+void
+DatabaseHandler::findClockNets() const
+{
+    clock_nets_.clear();
     sta::ClkArrivalSearchPred srch_pred(sta_);
     sta::BfsFwdIterator       bfs(sta::BfsIndex::other, &srch_pred, sta_);
     sta::PinSet               clk_pins;
@@ -3947,10 +5077,40 @@ DatabaseHandler::clockNets() const
         auto vertex = bfs.next();
         auto pin    = vertex->pin();
         Net* net    = network()->net(pin);
-        nets.insert(net);
+        if (net)
+        {
+            clock_nets_[id(net)] = 1;
+        }
         bfs.enqueueAdjacentVertices(vertex);
     }
-    return nets;
+    // Publishes the table to the lock-free readers in isClock()
+    clock_nets_valid_.store(true, std::memory_order_release);
+}
+void
+DatabaseHandler::setClock(Net* net, bool is_clock) const
+{
+    std::lock_guard<std::mutex> lock(clock_nets_mutex_);
+    // Nothing to maintain before the first lookup, the table is built from
+    // the current netlist then
+    if (!clock_nets_valid_.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    if (is_clock)
+    {
+        clock_nets_[id(net)] = 1;
+    }
+    else
+    {
+        clock_nets_.erase(id(net));
+    }
+}
+void
+DatabaseHandler::invalidateClockNets()
+{
+    std::lock_guard<std::mutex> lock(clock_nets_mutex_);
+    clock_nets_valid_.store(false, std::memory_order_release);
+    clock_nets_.clear();
 }
 void
 DatabaseHandler::slewLimit(InstanceTerm* pin, sta::MinMax* min_max,
@@ -4025,30 +5185,65 @@ DatabaseHandler::gateDelay(LibraryTerm* out_port, float load_cap,
     }
     auto cell = out_port->libertyCell();
     // Max rise/fall delays.
-    sta::ArcDelay                        max_delay = -sta::INF;
-    sta::LibertyCellTimingArcSetIterator set_iter(cell);
-    while (set_iter.hasNext())
+    sta::ArcDelay max_delay = -sta::INF;
+    for (auto& arc : compiledArcs(out_port))
     {
-        sta::TimingArcSet* arc_set = set_iter.next();
-        if (arc_set->to() == out_port)
+        float in_slew = tr_slew ? *tr_slew : target_slews_[arc.in_rf];
+        float gate_delay, drvr_slew;
+        arcDelay(cell, arc, in_slew, load_cap, gate_delay, drvr_slew);
+        max_delay = std::max(max_delay, gate_delay);
+    }
+    return max_delay;
+}
+
+void
+DatabaseHandler::gateDelays(LibraryTerm* out_port, const float* load_caps,
+                            float* delays, float* slews, size_t count,
+                            float* tr_slew)
+{
+    if (!has_target_loads_)
+    {
+        findTargetLoads();
+    }
+    auto cell = out_port->libertyCell();
+    std::fill(delays, delays + count, -sta::INF);
+    if (slews)
+    {
+        std::fill(slews, slews + count, -sta::INF);
+    }
+    std::vector<float> arc_values(count);
+    for (auto& arc : compiledArcs(out_port))
+    {
+        float in_slew = tr_slew ? *tr_slew : target_slews_[arc.in_rf];
+        if (!arc.compiled)
         {
-            sta::TimingArcSetArcIterator arc_iter(arc_set);
-            while (arc_iter.hasNext())
+            for (size_t i = 0; i < count; i++)
+            {
+                float gate_delay, drvr_slew;
+                arcDelay(cell, arc, in_slew, load_caps[i], gate_delay,
+                         drvr_slew);
+                delays[i] = std::max(delays[i], gate_delay);
+                if (slews)
+                {
+                    slews[i] = std::max(slews[i], drvr_slew);
+                }
+            }
+            continue;
+        }
+        arc.delay.findValues(in_slew, load_caps, arc_values.data(), count);
+        for (size_t i = 0; i < count; i++)
+        {
+            delays[i] = std::max(delays[i], arc_values[i]);
+        }
+        if (slews)
+        {
+            arc.slew.findValues(in_slew, load_caps, arc_values.data(), count);
+            for (size_t i = 0; i < count; i++)
             {
-                sta::TimingArc* arc   = arc_iter.next();
-                sta::RiseFall*  in_rf = arc->fromTrans()->asRiseFall();
-                float           in_slew =
-                    tr_slew ? *tr_slew : target_slews_[in_rf->index()];
-                sta::ArcDelay gate_delay;
-                sta::Slew     drvr_slew;
-                sta_->arcDelayCalc()->gateDelay(cell, arc, in_slew, load_cap,
-                                                nullptr, 0.0, pvt_, dcalc_ap_,
-                                                gate_delay, drvr_slew);
-                max_delay = std::max(max_delay, gate_delay);
+                slews[i] = std::max(slews[i], std::max(arc_values[i], 0.0F));
             }
         }
     }
-    return max_delay;
 }
 
 float
@@ -4058,6 +5253,15 @@ DatabaseHandler::bufferDelay(psn::LibraryCell* buffer_cell, float load_cap)
     buffer_cell->bufferPorts(input, output);
     return gateDelay(output, load_cap);
 }
+void
+DatabaseHandler::bufferDelays(psn::LibraryCell* buffer_cell,
+                              const float* load_caps, float* delays,
+                              size_t count)
+{
+    psn::LibraryTerm *input, *output;
+    buffer_cell->bufferPorts(input, output);
+    gateDelays(output, load_caps, delays, nullptr, count);
+}
 
 float
 DatabaseHandler::portCapacitance(const LibraryTerm* port, bool isMax) const
@@ -4161,6 +5365,7 @@ DatabaseHandler::dontSize(Instance* inst) const
 void
 DatabaseHandler::resetDelays()
 {
+    flushParasitics();
     sta_->graphDelayCalc()->delaysInvalid();
     sta_->search()->arrivalsInvalid();
     sta_->search()->requiredsInvalid();
@@ -4219,103 +5424,827 @@ DatabaseHandler::findBufferTargetSlews(Liberty* library,
 void
 DatabaseHandler::calculateParasitics()
 {
+    std::vector<Net*> signal_nets;
+    std::vector<Net*> edited_nets; // Skipped nets with pending edits
     for (auto& net : nets())
     {
         if (!isClock(net) && !network()->isPower(net) &&
             !network()->isGround(net))
         {
-            calculateParasitics(net);
+            signal_nets.push_back(net);
+        }
+        else if (dirty_nets_.count(net))
+        {
+            edited_nets.push_back(net);
         }
     }
+    dirty_nets_.clear();
+    for (auto& net : edited_nets)
+    {
+        computeParasitics(net);
+    }
+    if (compute_parasitics_callback_ != nullptr || parasitics_threads_ < 2)
+    {
+        for (auto& net : signal_nets)
+        {
+            computeParasitics(net);
+        }
+        return;
+    }
+
+    // The Steiner trees are built concurrently, the parasitics are then
+    // annotated from the calling thread. The nets are processed in chunks to
+    // bound the number of trees alive.
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration                   tree_time(0);
+    Clock::duration                   annotate_time(0);
+    size_t chunk_size = static_cast<size_t>(parasitics_threads_) * 256;
+    std::vector<std::unique_ptr<SteinerTree>> trees(chunk_size);
+#ifdef TF_ENABLED
+    tf::Executor executor(parasitics_threads_);
+#endif
+    for (size_t start = 0; start < signal_nets.size(); start += chunk_size)
+    {
+        size_t count = std::min(chunk_size, signal_nets.size() - start);
+        auto   build_tree = [&](int i) {
+            trees[i] = SteinerTree::create(signal_nets[start + i], psn_);
+        };
+        auto tree_start = Clock::now();
+#ifdef TF_ENABLED
+        tf::Taskflow taskflow;
+        taskflow.parallel_for(0, int(count), 1, build_tree);
+        executor.run(taskflow).wait();
+#else
+        for (size_t i = 0; i < count; i++)
+        {
+            build_tree(i);
+        }
+#endif
+        auto annotate_start = Clock::now();
+        tree_time += annotate_start - tree_start;
+        for (size_t i = 0; i < count; i++)
+        {
+            // Same journaling as computeParasitics()
+            journalNet(signal_nets[start + i]);
+            annotateParasitics(signal_nets[start + i], trees[i]);
+            trees[i].reset();
+        }
+        annotate_time += Clock::now() - annotate_start;
+    }
+    PSN_LOG_DEBUG(
+        "Parasitics of {} nets: Steiner trees {}ms, annotation {}ms",
+        signal_nets.size(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(tree_time)
+            .count(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(annotate_time)
+            .count());
+}
+void
+DatabaseHandler::setParasiticsThreads(int thread_count)
+{
+#ifndef TF_ENABLED
+    if (thread_count > 1)
+    {
+        PSN_LOG_WARN("Built without taskflow, the Steiner trees are built "
+                     "serially");
+    }
+#endif
+    parasitics_threads_ = std::max(thread_count, 1);
+}
+bool
+DatabaseHandler::setCharacterizationCache(const std::string& directory)
+{
+    characterization_dir_.clear();
+    characterization_key_valid_ = false;
+    if (directory.empty())
+    {
+        return true;
+    }
+    if (!FileUtils::createDirectoryIfNotExists(directory))
+    {
+        PSN_LOG_ERROR("Cannot create the characterization cache directory {}",
+                      directory);
+        return false;
+    }
+    characterization_dir_ = directory;
+    return true;
+}
+int
+DatabaseHandler::parasiticsThreads() const
+{
+    return parasitics_threads_;
 }
 bool
 DatabaseHandler::isClock(Net* net) const
 {
-    auto net_pin = faninPin(net);
-    if (net_pin)
+    // The table is only edited by the serial netlist edits, the concurrent
+    // readers only race on the first build
+    if (!clock_nets_valid_.load(std::memory_order_acquire))
     {
-        auto vert = vertex(net_pin);
-        if (vert)
+        std::lock_guard<std::mutex> lock(clock_nets_mutex_);
+        if (!clock_nets_valid_.load(std::memory_order_relaxed))
         {
+            findClockNets();
+        }
+    }
+    return clock_nets_.value(id(net));
+}
 
-            if (network()->search()->isClock(vert))
+void
+DatabaseHandler::calculateParasitics(Net* net)
+{
+    if (dirty_nets_.insert(net).second && journaling())
+    {
+        JournalEntry entry = JournalEntry();
+        entry.op           = JournalOp::MarkParasitics;
+        entry.net          = net;
+        journal_.push_back(std::move(entry));
+    }
+}
+void
+DatabaseHandler::flushParasitics() const
+{
+    // The pending timing edits are flushed with the parasitics so that every
+    // timing query sees them
+    flushTimingEdits();
+    if (dirty_nets_.empty())
+    {
+        return;
+    }
+    // The set is detached first since the parasitics callback can query the
+    // timing again
+    std::unordered_set<Net*> nets;
+    nets.swap(dirty_nets_);
+    for (auto& net : nets)
+    {
+        computeParasitics(net);
+    }
+}
+void
+DatabaseHandler::beginTimingEdit()
+{
+    timing_edit_depth_++;
+}
+void
+DatabaseHandler::endTimingEdit()
+{
+    if (timing_edit_depth_ > 0 && !--timing_edit_depth_)
+    {
+        flushTimingEdits();
+    }
+}
+void
+DatabaseHandler::touchTiming(InstanceTerm* term)
+{
+    if (timing_edit_depth_)
+    {
+        timing_edit_pins_.insert(term);
+    }
+    else
+    {
+        resetDelays(term);
+    }
+}
+void
+DatabaseHandler::flushTimingEdits() const
+{
+    // A pin touched several times, e.g. by a trial edit and its revert, is
+    // invalidated once
+    for (auto& pin : timing_edit_pins_)
+    {
+        sta_->delaysInvalidFrom(pin);
+        sta_->delaysInvalidFromFanin(pin);
+    }
+    timing_edit_pins_.clear();
+}
+void
+DatabaseHandler::updateTiming(InstanceTerm* term) const
+{
+    flushParasitics();
+    sta_->ensureLevelized();
+    sta_->vertexRequired(vertex(term), sta::MinMax::min());
+}
+void
+DatabaseHandler::checkpoint()
+{
+    // The pending parasitics are computed first so that the journal holds
+    // the previous parasitics of every net updated after the checkpoint
+    flushParasitics();
+    checkpoints_.push_back(journal_.size());
+    journaled_nets_.push_back(std::unordered_set<Net*>());
+    beginTimingEdit();
+}
+void
+DatabaseHandler::commit()
+{
+    if (checkpoints_.empty())
+    {
+        PSN_LOG_WARN("Commit without a checkpoint");
+        return;
+    }
+    checkpoints_.pop_back();
+    auto nets = std::move(journaled_nets_.back());
+    journaled_nets_.pop_back();
+    if (checkpoints_.empty())
+    {
+        journal_.clear();
+    }
+    else
+    {
+        // The snapshots are kept by the enclosing checkpoint
+        journaled_nets_.back().insert(nets.begin(), nets.end());
+    }
+    endTimingEdit();
+}
+void
+DatabaseHandler::rollback()
+{
+    if (checkpoints_.empty())
+    {
+        PSN_LOG_WARN("Rollback without a checkpoint");
+        return;
+    }
+    size_t journal_size = checkpoints_.back();
+    checkpoints_.pop_back();
+    journaled_nets_.pop_back();
+    rolling_back_ = true;
+
+    // Undoing a deletion creates a new object, the older entries are mapped
+    // to it
+    std::unordered_map<Instance*, Instance*> instances;
+    std::unordered_map<Net*, Net*>           nets;
+    auto map_instance = [&](Instance* inst) -> Instance* {
+        auto it = instances.find(inst);
+        return it != instances.end() ? it->second : inst;
+    };
+    auto map_net = [&](Net* net) -> Net* {
+        auto it = nets.find(net);
+        return it != nets.end() ? it->second : net;
+    };
+    std::function<InstanceTerm*(const JournalPin&)> resolve =
+        [&](const JournalPin& pin) -> InstanceTerm* {
+        // The port is matched by name, the pin may belong to a replaced cell
+        return network()->findPin(map_instance(pin.inst),
+                                  network()->name(pin.port));
+    };
+    // Reconnecting the pins drops the parasitics of their nets, so the
+    // parasitics are restored after the netlist
+    std::vector<JournalEntry> parasitics;
+
+    while (journal_.size() > journal_size)
+    {
+        JournalEntry entry = std::move(journal_.back());
+        journal_.pop_back();
+        switch (entry.op)
+        {
+        case JournalOp::Connect:
+        {
+            auto term = resolve(entry.pin);
+            if (term)
+            {
+                disconnect(term);
+            }
+            break;
+        }
+        case JournalOp::Disconnect:
+        {
+            auto term = resolve(entry.pin);
+            if (term)
+            {
+                connect(map_net(entry.net), term);
+            }
+            break;
+        }
+        case JournalOp::CreateInstance:
+            del(map_instance(entry.inst));
+            instances.erase(entry.inst);
+            break;
+        case JournalOp::DeleteInstance:
+        {
+            auto inst    = createInstance(entry.name.c_str(), entry.cell);
+            auto db_inst = network()->staToDb(inst);
+            db_inst->setOrient(odb::dbOrientType(
+                static_cast<odb::dbOrientType::Value>(entry.orient)));
+            db_inst->setLocation(entry.x, entry.y);
+            if (entry.flag)
             {
-                return true;
+                db_inst->setPlacementStatus(odb::dbPlacementStatus::PLACED);
             }
+            instances[entry.inst] = inst;
+            break;
+        }
+        case JournalOp::CreateNet:
+            del(map_net(entry.net));
+            nets.erase(entry.net);
+            break;
+        case JournalOp::DeleteNet:
+        {
+            auto net = createNet(entry.name.c_str());
+            setClock(net, entry.flag);
+            nets[entry.net] = net;
+            break;
+        }
+        case JournalOp::ReplaceCell:
+            replaceCell(map_instance(entry.inst), entry.cell);
+            break;
+        case JournalOp::Move:
+        {
+            auto db_inst = network()->staToDb(map_instance(entry.inst));
+            db_inst->setLocation(entry.x, entry.y);
+            db_inst->setPlacementStatus(entry.flag
+                                            ? odb::dbPlacementStatus::PLACED
+                                            : odb::dbPlacementStatus::UNPLACED);
+            break;
+        }
+        case JournalOp::MarkParasitics:
+            dirty_nets_.erase(map_net(entry.net));
+            break;
+        case JournalOp::Parasitics:
+            parasitics.push_back(std::move(entry));
+            break;
         }
     }
-
-    return false;
+    // The oldest snapshot of each net is restored last
+    for (auto& entry : parasitics)
+    {
+        restoreParasitics(entry, resolve);
+    }
+    rolling_back_ = false;
+    endTimingEdit();
+}
+bool
+DatabaseHandler::journaling() const
+{
+    return !checkpoints_.empty() && !rolling_back_;
 }
-
 void
-DatabaseHandler::calculateParasitics(Net* net)
+DatabaseHandler::journalNet(Net* net) const
+{
+    // The STA drops the reduced parasitics of a net when its connections
+    // change, they are saved before the first edit of the net
+    if (net && journaling() && journaled_nets_.back().insert(net).second)
+    {
+        journalParasitics(net);
+    }
+}
+void
+DatabaseHandler::journal(JournalOp op, InstanceTerm* term, Net* net) const
+{
+    JournalEntry entry = JournalEntry();
+    entry.op           = op;
+    entry.pin.inst     = network()->instance(term);
+    entry.pin.port     = network()->port(term);
+    entry.net          = net;
+    journal_.push_back(std::move(entry));
+}
+void
+DatabaseHandler::journalParasitics(Net* net) const
+{
+    JournalEntry entry = JournalEntry();
+    entry.op           = JournalOp::Parasitics;
+    entry.net          = net;
+    auto net_pins      = connectedPins(net);
+    for (auto& pin : net_pins)
+    {
+        if (!network()->isDriver(pin))
+        {
+            continue;
+        }
+        for (auto rf : sta::RiseFall::range())
+        {
+            JournalParasitic parasitic = JournalParasitic();
+            parasitic.driver.inst      = network()->instance(pin);
+            parasitic.driver.port      = network()->port(pin);
+            parasitic.rf_index         = rf->index();
+            auto pi_elmore =
+                sta_->parasitics()->findPiElmore(pin, rf, parasitics_ap_);
+            parasitic.exists = pi_elmore != nullptr;
+            if (pi_elmore)
+            {
+                sta_->parasitics()->piModel(pi_elmore, parasitic.c2,
+                                            parasitic.rpi, parasitic.c1);
+                for (auto& load : net_pins)
+                {
+                    float elmore;
+                    bool  exists;
+                    if (!network()->isLoad(load))
+                    {
+                        continue;
+                    }
+                    sta_->parasitics()->findElmore(pi_elmore, load, elmore,
+                                                   exists);
+                    if (exists)
+                    {
+                        JournalPin load_pin = {network()->instance(load),
+                                               network()->port(load)};
+                        parasitic.elmore.push_back(
+                            std::make_pair(load_pin, elmore));
+                    }
+                }
+            }
+            entry.parasitics.push_back(std::move(parasitic));
+        }
+    }
+    journal_.push_back(std::move(entry));
+}
+void
+DatabaseHandler::restoreParasitics(
+    const JournalEntry&                                    entry,
+    const std::function<InstanceTerm*(const JournalPin&)>& resolve)
+{
+    for (auto& parasitic : entry.parasitics)
+    {
+        auto driver = resolve(parasitic.driver);
+        if (!driver)
+        {
+            continue;
+        }
+        if (!parasitic.exists)
+        {
+            // Nothing to restore, the parasitics are computed again
+            auto driver_net = net(driver);
+            if (driver_net)
+            {
+                dirty_nets_.insert(driver_net);
+            }
+            continue;
+        }
+        auto rf        = parasitic.rf_index == sta::RiseFall::riseIndex()
+                             ? sta::RiseFall::rise()
+                             : sta::RiseFall::fall();
+        auto pi_elmore = sta_->parasitics()->makePiElmore(
+            driver, rf, parasitics_ap_, parasitic.c2, parasitic.rpi,
+            parasitic.c1);
+        for (auto& load : parasitic.elmore)
+        {
+            auto load_pin = resolve(load.first);
+            if (load_pin)
+            {
+                sta_->parasitics()->setElmore(pi_elmore, load_pin,
+                                              load.second);
+            }
+        }
+        touchTiming(driver);
+    }
+}
+void
+DatabaseHandler::computeParasitics(Net* net) const
 {
+    journalNet(net);
     if (compute_parasitics_callback_ != nullptr)
     {
         compute_parasitics_callback_(net);
         return;
     }
     auto tree = SteinerTree::create(net, psn_);
-    if (tree && tree->isPlaced())
-    {
-        sta::Parasitic* parasitic = sta_->parasitics()->makeParasiticNetwork(
-            net, false, parasitics_ap_);
-        int branch_count = tree->branchCount();
-        for (int i = 0; i < branch_count; i++)
-        {
-            auto                branch = tree->branch(i);
-            sta::ParasiticNode* n1 =
-                findParasiticNode(tree, parasitic, net, branch.firstPin(),
-                                  branch.firstSteinerPoint());
-            sta::ParasiticNode* n2 =
-                findParasiticNode(tree, parasitic, net, branch.secondPin(),
-                                  branch.secondSteinerPoint());
-            if (n1 != n2)
+    annotateParasitics(net, tree);
+}
+void
+DatabaseHandler::annotateParasitics(Net*                          net,
+                                    std::unique_ptr<SteinerTree>& tree) const
+{
+    if (!tree || !tree->isPlaced())
+    {
+        return;
+    }
+    // The RC tree is reduced directly from the Steiner branches using the
+    // same node mapping, moments and Elmore delays as the STA pi-elmore
+    // reduction, without building the parasitic network.
+    std::unordered_map<InstanceTerm*, int> pin_nodes;
+    std::unordered_map<SteinerPoint, int>  point_nodes;
+    std::vector<InstanceTerm*>             node_pins;
+    std::vector<float>                     wire_caps;
+    std::vector<int>                       edge_nodes;
+    std::vector<float>                     edge_res;
+
+    auto node_index = [&](InstanceTerm* pin, SteinerPoint pt) -> int {
+        if (pin == nullptr)
+        {
+            pin = tree->alias(pt);
+        }
+        int  index    = node_pins.size();
+        bool inserted = pin ? pin_nodes.emplace(pin, index).second
+                            : point_nodes.emplace(pt, index).second;
+        if (inserted)
+        {
+            node_pins.push_back(pin);
+            wire_caps.push_back(0.0);
+            return index;
+        }
+        return pin ? pin_nodes[pin] : point_nodes[pt];
+    };
+
+    int branch_count = tree->branchCount();
+    edge_nodes.reserve(2 * branch_count);
+    edge_res.reserve(branch_count);
+    for (int i = 0; i < branch_count; i++)
+    {
+        auto branch = tree->branch(i);
+        int  n1 = node_index(branch.firstPin(), branch.firstSteinerPoint());
+        int  n2 = node_index(branch.secondPin(), branch.secondSteinerPoint());
+        if (n1 != n2)
+        {
+            float wire_res = 1.0e-3;
+            if (branch.wireLength() != 0)
+            {
+                float wire_length = dbuToMeters(branch.wireLength());
+                float wire_cap    = wire_length * cap_per_micron_;
+                wire_res          = wire_length * res_per_micron_;
+                wire_caps[n1] += wire_cap / 2.0;
+                wire_caps[n2] += wire_cap / 2.0;
+            }
+            edge_nodes.push_back(n1);
+            edge_nodes.push_back(n2);
+            edge_res.push_back(wire_res);
+        }
+    }
+
+    // Compressed adjacency of the RC tree
+    int              node_count = node_pins.size();
+    int              edge_count = edge_res.size();
+    std::vector<int> adj_start(node_count + 1, 0);
+    std::vector<int> adj_edges(2 * edge_count);
+    for (auto& n : edge_nodes)
+    {
+        adj_start[n + 1]++;
+    }
+    for (int i = 0; i < node_count; i++)
+    {
+        adj_start[i + 1] += adj_start[i];
+    }
+    std::vector<int> adj_fill(adj_start.begin(), adj_start.end() - 1);
+    for (int i = 0; i < 2 * edge_count; i++)
+    {
+        adj_edges[adj_fill[edge_nodes[i]]++] = i / 2;
+    }
+
+    auto op_cond = sta_->sdc()->operatingConditions(sta::MinMax::max());
+
+    std::vector<int>    order(node_count);
+    std::vector<int>    parent(node_count);
+    std::vector<int>    parent_edge(node_count);
+    std::vector<double> y1(node_count), y2(node_count), y3(node_count);
+    std::vector<double> elmore(node_count);
+    for (int drvr_node = 0; drvr_node < node_count; drvr_node++)
+    {
+        InstanceTerm* drvr_pin = node_pins[drvr_node];
+        if (drvr_pin == nullptr || !network()->isDriver(drvr_pin))
+        {
+            continue;
+        }
+        // Pre-order walk from the driver, loop resistors are ignored
+        std::fill(parent.begin(), parent.end(), -1);
+        int visited            = 0;
+        order[visited++]       = drvr_node;
+        parent[drvr_node]      = drvr_node;
+        parent_edge[drvr_node] = -1;
+        for (int i = 0; i < visited; i++)
+        {
+            int node = order[i];
+            for (int j = adj_start[node]; j < adj_start[node + 1]; j++)
             {
-                if (branch.wireLength() == 0)
+                int edge  = adj_edges[j];
+                int other = edge_nodes[2 * edge] == node
+                                ? edge_nodes[2 * edge + 1]
+                                : edge_nodes[2 * edge];
+                if (parent[other] == -1)
                 {
-                    sta_->parasitics()->makeResistor(nullptr, n1, n2, 1.0e-3,
-                                                     parasitics_ap_);
+                    parent[other]      = node;
+                    parent_edge[other] = edge;
+                    order[visited++]   = other;
                 }
-                else
+            }
+        }
+        for (auto rf : sta::RiseFall::range())
+        {
+            // Driving point admittance moments, accumulated leaves first
+            for (int i = 0; i < visited; i++)
+            {
+                int           node = order[i];
+                InstanceTerm* pin  = node_pins[node];
+                y1[node]           = wire_caps[node];
+                y2[node]           = 0.0;
+                y3[node]           = 0.0;
+                if (pin && network()->isTopLevelPort(pin))
+                {
+                    // The load outside the block as set on the port
+                    float ext_cap;
+                    bool  exists;
+                    sta_->sdc()->portExtCap(network()->port(pin), rf,
+                                            sta::MinMax::max(), ext_cap,
+                                            exists);
+                    if (exists)
+                    {
+                        y1[node] += ext_cap;
+                    }
+                }
+                else if (pin)
+                {
+                    y1[node] += sta_->sdc()->pinCapacitance(
+                        pin, rf, op_cond, corner_, sta::MinMax::max());
+                }
+            }
+            for (int i = visited - 1; i > 0; i--)
+            {
+                int    node = order[i];
+                int    up   = parent[node];
+                double r    = edge_res[parent_edge[node]];
+                double d1   = y1[node];
+                double d2   = y2[node];
+                double d3   = y3[node];
+                y1[up] += d1;
+                y2[up] += d2 - r * d1 * d1;
+                y3[up] += d3 - 2.0 * r * d1 * d2 + r * r * d1 * d1 * d1;
+            }
+            double c1  = y1[drvr_node];
+            double c2  = 0.0;
+            double rpi = 0.0;
+            if (y2[drvr_node] != 0.0 || y3[drvr_node] != 0.0)
+            {
+                double m2 = y2[drvr_node];
+                double m3 = y3[drvr_node];
+                c1        = m2 * m2 / m3;
+                c2        = y1[drvr_node] - c1;
+                rpi       = -m3 * m3 / (m2 * m2 * m2);
+            }
+            sta::Parasitic* pi_elmore = sta_->parasitics()->makePiElmore(
+                drvr_pin, rf, parasitics_ap_, c2, rpi, c1);
+
+            elmore[drvr_node] = 0.0;
+            for (int i = 1; i < visited; i++)
+            {
+                int node     = order[i];
+                elmore[node] = elmore[parent[node]] +
+                               edge_res[parent_edge[node]] * y1[node];
+                InstanceTerm* pin = node_pins[node];
+                if (pin && network()->isLoad(pin))
                 {
-                    float wire_length = dbuToMeters(branch.wireLength());
-                    float wire_cap    = wire_length * cap_per_micron_;
-                    float wire_res    = wire_length * res_per_micron_;
-                    sta_->parasitics()->incrCap(n1, wire_cap / 2.0,
-                                                parasitics_ap_);
-                    sta_->parasitics()->makeResistor(nullptr, n1, n2, wire_res,
-                                                     parasitics_ap_);
-                    sta_->parasitics()->incrCap(n2, wire_cap / 2.0,
-                                                parasitics_ap_);
+                    sta_->parasitics()->setElmore(pi_elmore, pin,
+                                                  elmore[node]);
                 }
             }
         }
-        sta::ReduceParasiticsTo red = sta::ReduceParasiticsTo::pi_elmore;
-        auto cond = sta_->sdc()->operatingConditions(sta::MinMax::max());
-        sta_->parasitics()->reduceTo(parasitic, net, red, cond, corner_,
-                                     sta::MinMax::max(), parasitics_ap_);
-        sta_->parasitics()->deleteParasiticNetwork(net, parasitics_ap_);
     }
 }
-sta::ParasiticNode*
-DatabaseHandler::findParasiticNode(std::unique_ptr<SteinerTree>& tree,
-                                   sta::Parasitic* parasitic, const Net* net,
-                                   const InstanceTerm* pin, SteinerPoint pt)
+void
+DatabaseHandler::compileArcs(Liberty* lib)
 {
-    if (pin == nullptr)
+    sta::LibertyCellIterator cell_iter(lib);
+    while (cell_iter.hasNext())
     {
-        pin = tree->alias(pt);
+        sta::LibertyCellPortIterator port_iter(cell_iter.next());
+        while (port_iter.hasNext())
+        {
+            auto port = port_iter.next();
+            if (library_term_ids_.count(port))
+            {
+                continue;
+            }
+            library_term_ids_[port] = compiled_arcs_.size();
+            compiled_arcs_.push_back(CompiledArcs());
+            compileArcs(port, compiled_arcs_.back());
+        }
     }
-    if (pin)
+}
+const CompiledArcs&
+DatabaseHandler::compiledArcs(LibraryTerm* out_port)
+{
+    auto port_id = library_term_ids_.find(out_port);
+    if (port_id != library_term_ids_.end())
     {
-        return sta_->parasitics()->ensureParasiticNode(parasitic, pin);
+        return compiled_arcs_[port_id->second];
     }
-    else
+    // Libraries loaded outside readLib() are compiled on their first use
+    std::lock_guard<std::mutex> lock(compiled_arcs_mutex_);
+    auto&                       arcs = extra_compiled_arcs_[out_port];
+    if (!arcs)
+    {
+        arcs.reset(new CompiledArcs);
+        compileArcs(out_port, *arcs);
+    }
+    return *arcs;
+}
+void
+DatabaseHandler::compileArcs(LibraryTerm* out_port, CompiledArcs& arcs) const
+{
+    auto                                 cell = out_port->libertyCell();
+    sta::LibertyCellTimingArcSetIterator set_iter(cell);
+    while (set_iter.hasNext())
     {
-        return sta_->parasitics()->ensureParasiticNode(parasitic, net, pt);
+        sta::TimingArcSet* arc_set = set_iter.next();
+        if (arc_set->to() != out_port)
+        {
+            continue;
+        }
+        sta::TimingArcSetArcIterator arc_iter(arc_set);
+        while (arc_iter.hasNext())
+        {
+            sta::TimingArc* arc = arc_iter.next();
+            CompiledArc     compiled_arc(
+                arc, arc->fromTrans()->asRiseFall()->index(),
+                arc->toTrans()->asRiseFall()->index());
+            sta::GateTableModel* model =
+                dynamic_cast<sta::GateTableModel*>(arc->model());
+            if (model)
+            {
+                compiled_arc.compiled =
+                    compileTable(cell, model->delayModel(),
+                                 compiled_arc.delay) &&
+                    compileTable(cell, model->slewModel(), compiled_arc.slew);
+            }
+            arcs.push_back(compiled_arc);
+        }
+    }
+}
+bool
+DatabaseHandler::compileTable(LibraryCell* cell, const sta::TableModel* model,
+                              ArcTable& table) const
+{
+    if (!model)
+    {
+        // Missing models evaluate to zero
+        table = ArcTable();
+        return true;
+    }
+    int order = model->order();
+    if (order > 2)
+    {
+        return false;
+    }
+    const sta::TableAxis* axes[2]   = {model->axis1(), model->axis2()};
+    const sta::TableAxis* slew_axis = nullptr;
+    const sta::TableAxis* cap_axis  = nullptr;
+    for (int i = 0; i < order; i++)
+    {
+        switch (axes[i]->variable())
+        {
+        case sta::TableAxisVariable::input_net_transition:
+        case sta::TableAxisVariable::input_transition_time:
+            if (slew_axis)
+            {
+                return false;
+            }
+            slew_axis = axes[i];
+            break;
+        case sta::TableAxisVariable::total_output_net_capacitance:
+            if (cap_axis)
+            {
+                return false;
+            }
+            cap_axis = axes[i];
+            break;
+        default:
+            return false;
+        }
+    }
+    std::vector<float> slews(slew_axis ? slew_axis->size() : 1, 0.0);
+    std::vector<float> caps(cap_axis ? cap_axis->size() : 1, 0.0);
+    for (size_t i = 0; slew_axis && i < slews.size(); i++)
+    {
+        slews[i] = slew_axis->axisValue(i);
+    }
+    for (size_t i = 0; cap_axis && i < caps.size(); i++)
+    {
+        caps[i] = cap_axis->axisValue(i);
+    }
+    // Sampling the model at the axis points keeps the library scaling
+    std::vector<float> values(slews.size() * caps.size());
+    auto               library = cell->libertyLibrary();
+    for (size_t i = 0; i < slews.size(); i++)
+    {
+        for (size_t j = 0; j < caps.size(); j++)
+        {
+            float axis_values[2] = {0.0, 0.0};
+            for (int k = 0; k < order; k++)
+            {
+                axis_values[k] = axes[k] == slew_axis ? slews[i] : caps[j];
+            }
+            values[i * caps.size() + j] =
+                model->findValue(library, cell, pvt_, axis_values[0],
+                                 axis_values[1], 0.0);
+        }
+    }
+    table = ArcTable(std::move(slews), std::move(caps), std::move(values));
+    return true;
+}
+void
+DatabaseHandler::arcDelay(LibraryCell* cell, const CompiledArc& arc,
+                          float in_slew, float load_cap, float& delay,
+                          float& slew)
+{
+    if (arc.compiled)
+    {
+        delay = arc.delay.findValue(in_slew, load_cap);
+        // The delay calculator clips negative slews
+        slew = std::max(arc.slew.findValue(in_slew, load_cap), 0.0F);
+        return;
     }
+    sta::ArcDelay gate_delay;
+    sta::Slew     drvr_slew;
+    arcDelayCalc()->gateDelay(cell, arc.arc, in_slew, load_cap, nullptr, 0.0,
+                              pvt_, dcalc_ap_, gate_delay, drvr_slew);
+    delay = gate_delay;
+    slew  = drvr_slew;
 }
 HandlerType
 DatabaseHandler::handlerType() const
@@ -0,0 +1,154 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/ArcTable.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace psn
+{
+
+ArcTable::ArcTable() : slews_(1, 0.0), caps_(1, 0.0), values_(1, 0.0)
+{
+}
+
+ArcTable::ArcTable(std::vector<float> slews, std::vector<float> caps,
+                   std::vector<float> values)
+    : slews_(std::move(slews)),
+      caps_(std::move(caps)),
+      values_(std::move(values))
+{
+}
+
+size_t
+ArcTable::axisIndex(const std::vector<float>& axis, float value)
+{
+    size_t max = axis.size() - 1;
+    if (max == 0 || value <= axis[0])
+    {
+        return 0;
+    }
+    if (value >= axis[max])
+    {
+        return max - 1;
+    }
+    return std::upper_bound(axis.begin(), axis.end(), value) - axis.begin() -
+           1;
+}
+
+float
+ArcTable::findValue(float in_slew, float load_cap) const
+{
+    float value;
+    findValues(in_slew, &load_cap, &value, 1);
+    return value;
+}
+
+void
+ArcTable::findValues(float in_slew, const float* load_caps, float* values,
+                     size_t count) const
+{
+    size_t cap_count = caps_.size();
+    // Blend the two slew rows once, every load then reads a single row
+    float              row_storage[16];
+    std::vector<float> row_heap;
+    float*             row = row_storage;
+    if (cap_count > 16)
+    {
+        row_heap.resize(cap_count);
+        row = row_heap.data();
+    }
+    if (slews_.size() > 1)
+    {
+        size_t       index = axisIndex(slews_, in_slew);
+        const float* lower = values_.data() + index * cap_count;
+        const float* upper = lower + cap_count;
+        double       ds =
+            (in_slew - slews_[index]) / (slews_[index + 1] - slews_[index]);
+        for (size_t j = 0; j < cap_count; j++)
+        {
+            row[j] = (1.0 - ds) * lower[j] + ds * upper[j];
+        }
+    }
+    else
+    {
+        std::copy(values_.begin(), values_.end(), row);
+    }
+    if (cap_count == 1)
+    {
+        std::fill(values, values + count, row[0]);
+        return;
+    }
+    // The segment of each load is the number of inner axis points below it,
+    // which clamps to the end segments like axisIndex() without branching so
+    // the loop can be vectorized.
+    const float* caps = caps_.data();
+    for (size_t i = 0; i < count; i++)
+    {
+        float  load_cap = load_caps[i];
+        size_t index    = 0;
+        for (size_t j = 1; j + 1 < cap_count; j++)
+        {
+            index += load_cap >= caps[j];
+        }
+        float dc  = (load_cap - caps[index]) / (caps[index + 1] - caps[index]);
+        values[i] = row[index] + dc * (row[index + 1] - row[index]);
+    }
+}
+
+const std::vector<float>&
+ArcTable::slews() const
+{
+    return slews_;
+}
+
+const std::vector<float>&
+ArcTable::capacitances() const
+{
+    return caps_;
+}
+
+const std::vector<float>&
+ArcTable::values() const
+{
+    return values_;
+}
+
+CompiledArc::CompiledArc(sta::TimingArc* timing_arc, int in_rise_fall,
+                         int out_rise_fall)
+    : arc(timing_arc),
+      in_rf(in_rise_fall),
+      out_rf(out_rise_fall),
+      compiled(false)
+{
+}
+
+} // namespace psn
@@ -0,0 +1,424 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/CharacterizationCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace psn
+{
+
+static const char     cache_magic[8] = {'P', 'S', 'N', 'C', 'H', 'A', 'R', 0};
+static const uint32_t byte_order     = 0x01020304;
+
+// Bounds checked reading of the cache file
+class CacheReader
+{
+public:
+    CacheReader(const char* data, size_t size)
+        : data_(data), size_(size), pos_(0)
+    {
+    }
+    bool
+    read(void* value, size_t size)
+    {
+        if (size > size_ - pos_)
+        {
+            return false;
+        }
+        std::memcpy(value, data_ + pos_, size);
+        pos_ += size;
+        return true;
+    }
+    bool
+    skip(size_t size, const char*& start)
+    {
+        if (size > size_ - pos_)
+        {
+            return false;
+        }
+        start = data_ + pos_;
+        pos_ += size;
+        return true;
+    }
+    bool
+    done() const
+    {
+        return pos_ == size_;
+    }
+
+private:
+    const char* data_;
+    size_t      size_;
+    size_t      pos_;
+};
+
+template <class T>
+static void
+append(std::string& out, const T& value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static std::string
+encodePayload(const std::vector<std::string>& cells,
+              const std::vector<float>&       values)
+{
+    std::string payload;
+    append(payload, uint32_t(cells.size()));
+    for (auto& cell : cells)
+    {
+        append(payload, uint32_t(cell.size()));
+        payload.append(cell);
+    }
+    append(payload, uint32_t(values.size()));
+    payload.append(reinterpret_cast<const char*>(values.data()),
+                   values.size() * sizeof(float));
+    return payload;
+}
+
+static bool
+decodePayload(const char* data, size_t size, std::vector<std::string>& cells,
+              std::vector<float>& values)
+{
+    CacheReader reader(data, size);
+    uint32_t    count;
+    const char* start;
+    cells.clear();
+    values.clear();
+    if (!reader.read(&count, sizeof(count)))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t length;
+        if (!reader.read(&length, sizeof(length)) ||
+            !reader.skip(length, start))
+        {
+            return false;
+        }
+        cells.emplace_back(start, length);
+    }
+    if (!reader.read(&count, sizeof(count)) ||
+        size_t(count) > (size - sizeof(count)) / sizeof(float))
+    {
+        return false;
+    }
+    values.resize(count);
+    return reader.read(values.data(), count * sizeof(float)) && reader.done();
+}
+
+CharacterizationCache::CharacterizationCache()
+    : key_(0), map_(nullptr), map_size_(0)
+{
+}
+
+CharacterizationCache::~CharacterizationCache()
+{
+    unmap();
+}
+
+uint64_t
+CharacterizationCache::hashBytes(const void* data, size_t size,
+                                 uint64_t seed)
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        seed ^= bytes[i];
+        seed *= 1099511628211ULL;
+    }
+    return seed;
+}
+
+uint64_t
+CharacterizationCache::hash(const std::string& str, uint64_t seed)
+{
+    // Hash the size too so consecutive strings cannot be shifted
+    uint64_t size = str.size();
+    return hashBytes(str.data(), str.size(),
+                     hashBytes(&size, sizeof(size), seed));
+}
+
+bool
+CharacterizationCache::hashFile(const std::string& path, uint64_t& seed)
+{
+    std::ifstream infile(path, std::ios::binary);
+    if (!infile.is_open())
+    {
+        return false;
+    }
+    std::vector<char> buffer(1 << 16);
+    while (infile)
+    {
+        infile.read(buffer.data(), buffer.size());
+        seed = hashBytes(buffer.data(), infile.gcount(), seed);
+    }
+    return infile.eof();
+}
+
+void
+CharacterizationCache::reset(uint64_t key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmap();
+    inserted_.clear();
+    key_ = key;
+}
+
+bool
+CharacterizationCache::load(const std::string& path, uint64_t key)
+{
+    reset(key);
+    std::lock_guard<std::mutex> lock(mutex_);
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+        void* map =
+            mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            map_      = map;
+            map_size_ = file_stat.st_size;
+        }
+    }
+    close(fd);
+#endif
+    if (!map_)
+    {
+        std::ifstream infile(path, std::ios::binary);
+        if (!infile.is_open())
+        {
+            return false;
+        }
+        file_data_.assign(std::istreambuf_iterator<char>(infile),
+                          std::istreambuf_iterator<char>());
+    }
+    const char* data =
+        map_ ? static_cast<const char*>(map_) : file_data_.data();
+    size_t size = map_ ? map_size_ : file_data_.size();
+    if (!parse(data, size, key))
+    {
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+bool
+CharacterizationCache::parse(const char* data, size_t size, uint64_t key)
+{
+    CacheReader reader(data, size);
+    char        magic[sizeof(cache_magic)];
+    uint32_t    file_version, file_byte_order;
+    uint64_t    file_key, count;
+    if (!reader.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, cache_magic, sizeof(magic)) ||
+        !reader.read(&file_version, sizeof(file_version)) ||
+        file_version != version ||
+        !reader.read(&file_byte_order, sizeof(file_byte_order)) ||
+        file_byte_order != byte_order ||
+        !reader.read(&file_key, sizeof(file_key)) || file_key != key ||
+        !reader.read(&count, sizeof(count)))
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint32_t    name_size;
+        uint64_t    payload_size;
+        const char* name;
+        const char* payload;
+        if (!reader.read(&name_size, sizeof(name_size)) ||
+            !reader.skip(name_size, name) ||
+            !reader.read(&payload_size, sizeof(payload_size)) ||
+            !reader.skip(payload_size, payload))
+        {
+            loaded_.clear();
+            return false;
+        }
+        loaded_[std::string(name, name_size)] = Payload(payload, payload_size);
+    }
+    if (!reader.done())
+    {
+        loaded_.clear();
+        return false;
+    }
+    return true;
+}
+
+bool
+CharacterizationCache::save(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string                 content(cache_magic, sizeof(cache_magic));
+    append(content, uint32_t(version));
+    append(content, byte_order);
+    append(content, key_);
+    uint64_t count = inserted_.size();
+    for (auto& record : loaded_)
+    {
+        count += !inserted_.count(record.first);
+    }
+    append(content, count);
+    auto write_record = [&](const std::string& name, const char* payload,
+                            size_t payload_size) {
+        append(content, uint32_t(name.size()));
+        content.append(name);
+        append(content, uint64_t(payload_size));
+        content.append(payload, payload_size);
+    };
+    for (auto& record : loaded_)
+    {
+        if (!inserted_.count(record.first))
+        {
+            write_record(record.first, record.second.first,
+                         record.second.second);
+        }
+    }
+    for (auto& record : inserted_)
+    {
+        write_record(record.first, record.second.data(), record.second.size());
+    }
+
+    std::string temp_path = path + ".tmp";
+#ifndef _WIN32
+    temp_path += std::to_string(getpid());
+#endif
+    {
+        std::ofstream outfile(temp_path, std::ios::binary | std::ios::trunc);
+        if (!outfile.is_open())
+        {
+            return false;
+        }
+        outfile.write(content.data(), content.size());
+        if (!outfile.good())
+        {
+            outfile.close();
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()))
+    {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t
+CharacterizationCache::key() const
+{
+    return key_;
+}
+
+size_t
+CharacterizationCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t                      count = inserted_.size();
+    for (auto& record : loaded_)
+    {
+        count += !inserted_.count(record.first);
+    }
+    return count;
+}
+
+bool
+CharacterizationCache::modified() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !inserted_.empty();
+}
+
+bool
+CharacterizationCache::find(const std::string&        name,
+                            std::vector<std::string>& cells,
+                            std::vector<float>&       values) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto                        inserted_it = inserted_.find(name);
+    if (inserted_it != inserted_.end())
+    {
+        return decodePayload(inserted_it->second.data(),
+                             inserted_it->second.size(), cells, values);
+    }
+    auto loaded_it = loaded_.find(name);
+    if (loaded_it != loaded_.end())
+    {
+        return decodePayload(loaded_it->second.first,
+                             loaded_it->second.second, cells, values);
+    }
+    return false;
+}
+
+void
+CharacterizationCache::insert(const std::string&              name,
+                              const std::vector<std::string>& cells,
+                              const std::vector<float>&       values)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    inserted_[name] = encodePayload(cells, values);
+}
+
+void
+CharacterizationCache::unmap()
+{
+    loaded_.clear();
+    file_data_.clear();
+#ifndef _WIN32
+    if (map_)
+    {
+        munmap(map_, map_size_);
+    }
+#endif
+    map_      = nullptr;
+    map_size_ = 0;
+}
+
+} // namespace psn
@@ -0,0 +1,213 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include "OpenPhySyn/Liberty/CompiledFunction.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace psn
+{
+
+CompiledFunction::CompiledFunction(std::vector<LibraryTerm*> inputs)
+    : inputs_(std::move(inputs)),
+      used_inputs_(0),
+      depth_(0),
+      max_depth_(0),
+      valid_(inputs_.size() <= max_inputs)
+{
+}
+
+void
+CompiledFunction::pushInput(int index)
+{
+    if (index < 0 || size_t(index) >= inputs_.size())
+    {
+        invalidate();
+        return;
+    }
+    code_.push_back({Input, index});
+    used_inputs_ |= uint64_t(1) << index;
+    max_depth_ = std::max(max_depth_, ++depth_);
+}
+
+void
+CompiledFunction::pushConstant(bool value)
+{
+    code_.push_back({value ? One : Zero, -1});
+    max_depth_ = std::max(max_depth_, ++depth_);
+}
+
+void
+CompiledFunction::pushOperation(Operation op)
+{
+    int operands = op == Not ? 1 : 2;
+    if (op == Input || op == One || op == Zero || depth_ < operands)
+    {
+        invalidate();
+        return;
+    }
+    code_.push_back({op, -1});
+    depth_ -= operands - 1;
+}
+
+void
+CompiledFunction::invalidate()
+{
+    valid_ = false;
+}
+
+bool
+CompiledFunction::valid() const
+{
+    return valid_ && depth_ == 1;
+}
+
+const std::vector<LibraryTerm*>&
+CompiledFunction::inputs() const
+{
+    return inputs_;
+}
+
+int
+CompiledFunction::inputIndex(LibraryTerm* term) const
+{
+    auto itr = std::find(inputs_.begin(), inputs_.end(), term);
+    return itr == inputs_.end() ? -1 : int(itr - inputs_.begin());
+}
+
+uint64_t
+CompiledFunction::usedInputs() const
+{
+    return used_inputs_;
+}
+
+uint64_t
+CompiledFunction::run(const uint64_t* input_words) const
+{
+    if (code_.empty())
+    {
+        return 0;
+    }
+    const int             stack_size = 32;
+    uint64_t              fixed_stack[stack_size] = {};
+    std::vector<uint64_t> heap_stack;
+    uint64_t*             stack = fixed_stack;
+    if (max_depth_ > stack_size)
+    {
+        heap_stack.resize(max_depth_);
+        stack = heap_stack.data();
+    }
+    int top = -1;
+    for (auto& inst : code_)
+    {
+        switch (inst.op)
+        {
+        case Input:
+            stack[++top] = input_words[inst.input];
+            break;
+        case One:
+            stack[++top] = ~uint64_t(0);
+            break;
+        case Zero:
+            stack[++top] = 0;
+            break;
+        case Not:
+            stack[top] = ~stack[top];
+            break;
+        case And:
+            stack[top - 1] &= stack[top];
+            top--;
+            break;
+        case Or:
+            stack[top - 1] |= stack[top];
+            top--;
+            break;
+        case Xor:
+            stack[top - 1] ^= stack[top];
+            top--;
+            break;
+        }
+    }
+    return stack[0];
+}
+
+int
+CompiledFunction::evaluate(uint64_t input_bits) const
+{
+    if (!valid())
+    {
+        return -1;
+    }
+    uint64_t input_words[max_inputs];
+    for (size_t i = 0; i < inputs_.size(); i++)
+    {
+        input_words[i] = ((input_bits >> i) & 1) ? ~uint64_t(0) : 0;
+    }
+    return run(input_words) & 1;
+}
+
+bool
+CompiledFunction::truthTable(std::vector<uint64_t>& table) const
+{
+    if (!valid() || inputs_.size() > max_table_inputs)
+    {
+        return false;
+    }
+    // The six lowest inputs change within a word, the others are constant
+    // over a word and follow the bits of the word index
+    static const uint64_t low_input_words[] = {
+        0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull};
+    size_t input_count = inputs_.size();
+    size_t words = input_count > 6 ? size_t(1) << (input_count - 6) : 1;
+    table.resize(words);
+    uint64_t input_words[max_table_inputs];
+    for (size_t i = 0; i < input_count && i < 6; i++)
+    {
+        input_words[i] = low_input_words[i];
+    }
+    for (size_t w = 0; w < words; w++)
+    {
+        for (size_t i = 6; i < input_count; i++)
+        {
+            input_words[i] = ((w >> (i - 6)) & 1) ? ~uint64_t(0) : 0;
+        }
+        table[w] = run(input_words);
+    }
+    if (input_count < 6)
+    {
+        // Clear the minterms past the table
+        table[0] &= (uint64_t(1) << (size_t(1) << input_count)) - 1;
+    }
+    return true;
+}
+
+} // namespace psn
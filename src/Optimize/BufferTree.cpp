@@ -38,6 +38,9 @@
 #include "OpenPhySyn/Utils/PsnGlobal.hpp"
 #include "PsnLogger/PsnLogger.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
 
 
@@ -69,8 +72,8 @@ BufferTree::BufferTree(float cap, float req, float cost, Point location,
 
 {
 }
-BufferTree::BufferTree(Psn* psn_inst, std::shared_ptr<BufferTree> left,
-                       std::shared_ptr<BufferTree> right, Point location)
+BufferTree::BufferTree(Psn* psn_inst, BufferTree* left, BufferTree* right,
+                       Point location)
     : capacitance_(left->totalCapacitance() + right->totalCapacitance()),
       required_or_slew_(left->mode() == Timerless
                             ? (std::max(left->totalRequiredOrSlew(),
@@ -349,23 +352,23 @@ BufferTree::libraryPin() const
 {
     return library_pin_;
 }
-std::shared_ptr<BufferTree>&
-BufferTree::left()
+BufferTree*
+BufferTree::left() const
 {
     return left_;
 }
-std::shared_ptr<BufferTree>&
-BufferTree::right()
+BufferTree*
+BufferTree::right() const
 {
     return right_;
 }
 void
-BufferTree::setLeft(std::shared_ptr<BufferTree> left)
+BufferTree::setLeft(BufferTree* left)
 {
     left_ = left;
 }
 void
-BufferTree::setRight(std::shared_ptr<BufferTree> right)
+BufferTree::setRight(BufferTree* right)
 {
     right_ = right;
 }
@@ -520,67 +523,203 @@ TimerlessBufferTree::TimerlessBufferTree(float cap, float req, float cost,
                  polarity, BufferMode::Timerless)
 {
 }
-TimerlessBufferTree::TimerlessBufferTree(Psn*                        psn_inst,
-                                         std::shared_ptr<BufferTree> left,
-                                         std::shared_ptr<BufferTree> right,
-                                         Point                       location)
+TimerlessBufferTree::TimerlessBufferTree(Psn* psn_inst, BufferTree* left,
+                                         BufferTree* right, Point location)
     : BufferTree(psn_inst, left, right, location)
 {
     setMode(BufferMode::Timerless);
 }
 
-BufferSolution::BufferSolution(BufferMode buffer_mode) : mode_(buffer_mode){};
+BufferTreeArena::BufferTreeArena(size_t block_size)
+    : block_size_(block_size), size_(0)
+{
+}
+BufferTree*
+BufferTreeArena::allocate()
+{
+    size_t block  = size_ / block_size_;
+    size_t offset = size_ % block_size_;
+    if (block == blocks_.size())
+    {
+        blocks_.emplace_back(new BufferTree[block_size_]);
+    }
+    size_++;
+    return &blocks_[block][offset];
+}
+void
+BufferTreeArena::reset()
+{
+    // The reused nodes must not keep the resynthesis mappings alive
+    for (size_t i = 0; i < size_; i++)
+    {
+        blocks_[i / block_size_][i % block_size_].setLibraryMappingNode(
+            nullptr);
+    }
+    size_ = 0;
+}
+size_t
+BufferTreeArena::size() const
+{
+    return size_;
+}
+size_t
+BufferTreeArena::capacity() const
+{
+    return blocks_.size() * block_size_;
+}
+
+void
+BufferCandidates::clear()
+{
+    capacitance.clear();
+    required_or_slew.clear();
+    cost.clear();
+    polarity.clear();
+    buffer_count.clear();
+    tree.clear();
+    left.clear();
+    right.clear();
+}
+void
+BufferCandidates::reserve(size_t count)
+{
+    capacitance.reserve(count);
+    required_or_slew.reserve(count);
+    cost.reserve(count);
+    polarity.reserve(count);
+    buffer_count.reserve(count);
+    tree.reserve(count);
+    left.reserve(count);
+    right.reserve(count);
+}
+size_t
+BufferCandidates::size() const
+{
+    return capacitance.size();
+}
+void
+BufferCandidates::add(BufferTree* candidate_tree)
+{
+    capacitance.push_back(candidate_tree->totalCapacitance());
+    required_or_slew.push_back(candidate_tree->totalRequiredOrSlew());
+    cost.push_back(candidate_tree->cost());
+    polarity.push_back(candidate_tree->polarity());
+    buffer_count.push_back(candidate_tree->bufferCount());
+    tree.push_back(candidate_tree);
+    left.push_back(candidate_tree->left());
+    right.push_back(candidate_tree->right());
+}
+void
+BufferCandidates::add(float cap, float req_or_slew, float candidate_cost,
+                      int candidate_polarity, int candidate_buffer_count,
+                      BufferTree* left_branch, BufferTree* right_branch)
+{
+    capacitance.push_back(cap);
+    required_or_slew.push_back(req_or_slew);
+    cost.push_back(candidate_cost);
+    polarity.push_back(candidate_polarity);
+    buffer_count.push_back(candidate_buffer_count);
+    tree.push_back(nullptr);
+    left.push_back(left_branch);
+    right.push_back(right_branch);
+}
+template <typename T>
+static void
+selectIndices(std::vector<T>& values, const std::vector<size_t>& indices)
+{
+    std::vector<T> selected(indices.size());
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        selected[i] = values[indices[i]];
+    }
+    values.swap(selected);
+}
+void
+BufferCandidates::select(const std::vector<size_t>& indices)
+{
+    selectIndices(capacitance, indices);
+    selectIndices(required_or_slew, indices);
+    selectIndices(cost, indices);
+    selectIndices(polarity, indices);
+    selectIndices(buffer_count, indices);
+    selectIndices(tree, indices);
+    selectIndices(left, indices);
+    selectIndices(right, indices);
+}
+
+BufferSolution::BufferSolution(BufferTreeArena& arena, BufferMode buffer_mode)
+    : mode_(buffer_mode), arena_(&arena), approximation_loss_(0.0){};
 BufferSolution::BufferSolution(Psn*                             psn_inst,
                                std::shared_ptr<BufferSolution>& left,
                                std::shared_ptr<BufferSolution>& right,
                                Point location, LibraryCell* upstream_res_cell,
                                float      minimum_upstream_res_or_max_slew,
-                               BufferMode buffer_mode)
-    : mode_(buffer_mode)
+                               BufferMode buffer_mode, bool squeeze_pruning,
+                               size_t max_candidates)
+    : mode_(buffer_mode), arena_(left->arena()), approximation_loss_(0.0)
 
 {
     mergeBranches(psn_inst, left, right, location, upstream_res_cell,
-                  minimum_upstream_res_or_max_slew);
+                  minimum_upstream_res_or_max_slew, squeeze_pruning,
+                  max_candidates);
 }
 void
 BufferSolution::mergeBranches(Psn*                             psn_inst,
                               std::shared_ptr<BufferSolution>& left,
                               std::shared_ptr<BufferSolution>& right,
                               Point location, LibraryCell* upstream_res_cell,
-                              float minimum_upstream_res_or_max_slew)
-{
-    buffer_trees_.resize(left->bufferTrees().size() *
-                             right->bufferTrees().size(),
-                         std::make_shared<BufferTree>());
-    int index = 0;
-    for (auto& left_branch : left->bufferTrees())
+                              float  minimum_upstream_res_or_max_slew,
+                              bool   squeeze_pruning,
+                              size_t max_candidates)
+{
+    auto& left_trees  = left->bufferTrees();
+    auto& right_trees = right->bufferTrees();
+    candidates_.clear();
+    candidates_.reserve(left_trees.size() * right_trees.size());
+    for (auto& left_branch : left_trees)
     {
-        for (auto& right_branch : right->bufferTrees())
+        float left_cap      = left_branch->totalCapacitance();
+        float left_req      = left_branch->totalRequiredOrSlew();
+        float left_cost     = left_branch->cost();
+        int   left_polarity = left_branch->polarity();
+        int   left_count    = left_branch->bufferCount();
+        for (auto& right_branch : right_trees)
         {
-            if (left_branch->polarity() == right_branch->polarity())
+            if (left_polarity == right_branch->polarity())
             {
-                buffer_trees_[index++] =
-                    isTimerless()
-                        ? std::make_shared<TimerlessBufferTree>(
-                              psn_inst, left_branch, right_branch, location)
-                        : std::make_shared<BufferTree>(psn_inst, left_branch,
-                                                       right_branch, location);
+                float right_req = right_branch->totalRequiredOrSlew();
+                candidates_.add(left_cap + right_branch->totalCapacitance(),
+                                isTimerless() ? std::max(left_req, right_req)
+                                              : std::min(left_req, right_req),
+                                left_cost + right_branch->cost(), 0,
+                                left_count + right_branch->bufferCount(),
+                                left_branch, right_branch);
             }
         }
     }
-    buffer_trees_.resize(index);
-    prune(psn_inst, upstream_res_cell, minimum_upstream_res_or_max_slew);
+    // Only the trees that survive pruning are created.
+    approximation_loss_ =
+        std::max(left->approximationLoss(), right->approximationLoss()) +
+        pruneCandidates(psn_inst, upstream_res_cell,
+                        minimum_upstream_res_or_max_slew, 1E-6F, 1E-6F,
+                        squeeze_pruning, max_candidates);
+    materializeCandidates(psn_inst, location);
 }
 void
-BufferSolution::addTree(std::shared_ptr<BufferTree>& tree)
+BufferSolution::addTree(BufferTree* tree)
 {
     buffer_trees_.push_back(tree);
 }
-std::vector<std::shared_ptr<BufferTree>>&
+std::vector<BufferTree*>&
 BufferSolution::bufferTrees()
 {
     return buffer_trees_;
 }
+BufferTreeArena*
+BufferSolution::arena() const
+{
+    return arena_;
+}
 void
 BufferSolution::addWireDelayAndCapacitance(float wire_res, float wire_cap)
 {
@@ -616,46 +755,53 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
     }
     if (!isTimerless())
     {
-
-        for (auto& buff : buffer_lib)
+        DatabaseHandler&   handler = *(psn_inst->handler());
+        std::vector<float> caps, reqs, delays;
+        for (auto& tree : buffer_trees_)
         {
-            auto optimal_tree  = *(buffer_trees_.begin());
-            auto buff_required = optimal_tree->bufferRequired(psn_inst, buff);
-            for (auto& tree : buffer_trees_)
+            caps.push_back(tree->totalCapacitance());
+            reqs.push_back(tree->totalRequiredOrSlew());
+        }
+        // Index of the candidate with the latest required time at the input
+        // of the cell, the cell delays are evaluated in one batch
+        auto optimal_index = [&](LibraryCell* cell) -> size_t {
+            delays.resize(caps.size());
+            handler.bufferDelays(cell, caps.data(), delays.data(),
+                                 caps.size());
+            size_t optimal = 0;
+            for (size_t i = 1; i < caps.size(); i++)
             {
-                auto req = tree->bufferRequired(psn_inst, buff);
-                if (req > buff_required)
+                if (reqs[i] - delays[i] > reqs[optimal] - delays[optimal])
                 {
-                    optimal_tree  = tree;
-                    buff_required = req;
+                    optimal = i;
                 }
             }
-            auto buffer_cost = psn_inst->handler()->area(buff);
-            auto buffer_cap = psn_inst->handler()->bufferInputCapacitance(buff);
-            auto buffer_opt = std::make_shared<BufferTree>(
+            return optimal;
+        };
+        for (auto& buff : buffer_lib)
+        {
+            size_t optimal       = optimal_index(buff);
+            auto   optimal_tree  = buffer_trees_[optimal];
+            auto   buff_required = reqs[optimal] - delays[optimal];
+            auto   buffer_cost   = handler.area(buff);
+            auto   buffer_cap    = handler.bufferInputCapacitance(buff);
+            auto   buffer_opt    = arena_->create(
                 buffer_cap, buff_required, optimal_tree->cost() + buffer_cost,
                 pt, nullptr, nullptr, buff);
             buffer_opt->setBufferCount(optimal_tree->bufferCount() + 1);
             buffer_opt->setLeft(optimal_tree);
             buffer_trees_.push_back(buffer_opt);
+            caps.push_back(buffer_opt->totalCapacitance());
+            reqs.push_back(buffer_opt->totalRequiredOrSlew());
         }
         for (auto& inv : inverter_lib)
         {
-            auto optimal_tree  = *(buffer_trees_.begin());
-            auto buff_required = optimal_tree->bufferRequired(psn_inst, inv);
-            for (auto& tree : buffer_trees_)
-            {
-                auto req = tree->bufferRequired(psn_inst, inv);
-                if (req > buff_required)
-                {
-                    optimal_tree  = tree;
-                    buff_required = req;
-                }
-            }
-            auto buffer_cost = psn_inst->handler()->area(inv);
-            auto buffer_cap =
-                psn_inst->handler()->inverterInputCapacitance(inv);
-            auto buffer_opt = std::make_shared<BufferTree>(
+            size_t optimal       = optimal_index(inv);
+            auto   optimal_tree  = buffer_trees_[optimal];
+            auto   buff_required = reqs[optimal] - delays[optimal];
+            auto   buffer_cost   = handler.area(inv);
+            auto   buffer_cap    = handler.inverterInputCapacitance(inv);
+            auto   buffer_opt    = arena_->create(
                 buffer_cap, buff_required, optimal_tree->cost() + buffer_cost,
                 pt, nullptr, nullptr, inv);
 
@@ -664,17 +810,18 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
 
             buffer_opt->setLeft(optimal_tree);
             buffer_trees_.push_back(buffer_opt);
+            caps.push_back(buffer_opt->totalCapacitance());
+            reqs.push_back(buffer_opt->totalRequiredOrSlew());
         }
     }
     else
     {
         std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                  [&](const std::shared_ptr<BufferTree>& a,
-                      const std::shared_ptr<BufferTree>& b) -> bool {
+                  [&](const BufferTree* a, const BufferTree* b) -> bool {
                       return a->cost() < b->cost();
                   });
         // auto sol_tree = buffer_trees_[0];
-        std::vector<std::shared_ptr<BufferTree>> new_trees;
+        std::vector<BufferTree*> new_trees;
         for (auto& buff : buffer_lib)
         {
             for (auto& sol_tree : buffer_trees_)
@@ -686,7 +833,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
                     sol_tree->bufferSlew(psn_inst, buff, slew_limit);
                 if (buffer_slew < slew_limit)
                 {
-                    auto buffer_opt = std::make_shared<TimerlessBufferTree>(
+                    auto buffer_opt = arena_->createTimerless(
                         buffer_cap, 0, sol_tree->cost() + buffer_cost, pt,
                         nullptr, nullptr, buff);
                     buffer_opt->setBufferCount(sol_tree->bufferCount() + 1);
@@ -706,7 +853,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
                 float buffer_slew = sol_tree->bufferSlew(psn_inst, inv);
                 if (buffer_slew < slew_limit)
                 {
-                    auto buffer_opt = std::make_shared<TimerlessBufferTree>(
+                    auto buffer_opt = arena_->createTimerless(
                         buffer_cap, 0, sol_tree->cost() + buffer_cost, pt,
                         nullptr, nullptr, inv);
                     buffer_opt->setBufferCount(sol_tree->bufferCount() + 1);
@@ -723,7 +870,7 @@ BufferSolution::addLeafTrees(Psn* psn_inst, InstanceTerm*, Point pt,
         buffer_trees_.erase(
             std::remove_if(
                 buffer_trees_.begin(), buffer_trees_.end(),
-                [&](const std::shared_ptr<BufferTree>& t) -> bool {
+                [&](BufferTree* t) -> bool {
                     if ((t->isBufferNode() &&
                          std::sqrt(std::pow(t->totalRequiredOrSlew(), 2) +
                                    std::pow(psn_inst->handler()->bufferDelay(
@@ -772,7 +919,7 @@ BufferSolution::addLeafTreesWithResynthesis(
         }
         auto buffer_cost = psn_inst->handler()->area(buff);
         auto buffer_cap  = psn_inst->handler()->bufferInputCapacitance(buff);
-        auto buffer_opt  = std::make_shared<BufferTree>(
+        auto buffer_opt  = arena_->create(
             buffer_cap, buff_required, optimal_tree->cost() + buffer_cost, pt,
             nullptr, nullptr, buff);
         buffer_opt->setBufferCount(optimal_tree->bufferCount() + 1);
@@ -798,7 +945,7 @@ BufferSolution::addLeafTreesWithResynthesis(
             auto buffer_cost = psn_inst->handler()->area(inv);
             auto buffer_cap =
                 psn_inst->handler()->inverterInputCapacitance(inv);
-            auto buffer_opt = std::make_shared<BufferTree>(
+            auto buffer_opt = arena_->create(
                 buffer_cap, buff_required, optimal_tree->cost() + buffer_cost,
                 pt, nullptr, nullptr, inv);
 
@@ -836,7 +983,7 @@ BufferSolution::addLeafTreesWithResynthesis(
                     auto buffer_cost = psn_inst->handler()->area(buff);
                     auto buffer_cap =
                         psn_inst->handler()->bufferInputCapacitance(buff);
-                    auto buffer_opt = std::make_shared<BufferTree>(
+                    auto buffer_opt = arena_->create(
                         buffer_cap, buff_required,
                         optimal_tree->cost() + buffer_cost, pt, nullptr,
                         nullptr, buff);
@@ -868,7 +1015,7 @@ BufferSolution::addLeafTreesWithResynthesis(
                         auto buffer_cost = psn_inst->handler()->area(inv);
                         auto buffer_cap =
                             psn_inst->handler()->inverterInputCapacitance(inv);
-                        auto buffer_opt = std::make_shared<BufferTree>(
+                        auto buffer_opt = arena_->create(
                             buffer_cap, buff_required,
                             optimal_tree->cost() + buffer_cost, pt, nullptr,
                             nullptr, inv);
@@ -887,8 +1034,8 @@ BufferSolution::addLeafTreesWithResynthesis(
     }
 }
 void
-BufferSolution::addUpstreamReferences(
-    Psn* psn_inst, std::shared_ptr<BufferTree> base_buffer_tree)
+BufferSolution::addUpstreamReferences(Psn*        psn_inst,
+                                      BufferTree* base_buffer_tree)
 {
     return; // Not used anymore..
     for (auto& tree : bufferTrees())
@@ -911,7 +1058,7 @@ BufferSolution::addUpstreamReferences(
     }
 }
 
-std::shared_ptr<BufferTree>
+BufferTree*
 BufferSolution::optimalDriverTreeWithResize(
     Psn* psn_inst, InstanceTerm* driver_pin,
     std::vector<LibraryCell*> driver_types, float area_penalty)
@@ -920,9 +1067,9 @@ BufferSolution::optimalDriverTreeWithResize(
     {
         return nullptr;
     }
-    float                       max_slack;
-    std::shared_ptr<BufferTree> temp_tree;
-    auto                        max_tree =
+    float       max_slack;
+    BufferTree* temp_tree = nullptr;
+    auto        max_tree =
         optimalDriverTree(psn_inst, driver_pin, temp_tree, &max_slack);
     auto inst         = psn_inst->handler()->instance(driver_pin);
     auto original_lib = psn_inst->handler()->libraryCell(inst);
@@ -958,7 +1105,7 @@ BufferSolution::optimalDriverTreeWithResize(
     }
     return max_tree;
 }
-std::shared_ptr<BufferTree>
+BufferTree*
 BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
                                                  InstanceTerm* driver_pin,
                                                  float         area_penalty,
@@ -972,8 +1119,7 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
 
     auto first_tree = buffer_trees_[0];
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [&](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [&](const BufferTree* a, const BufferTree* b) -> bool {
                   float a_delay = psn_inst->handler()->gateDelay(
                       driver_pin, a->totalCapacitance());
                   float a_slack = a->totalRequiredOrSlew() - a_delay;
@@ -985,13 +1131,13 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
                           a->cost() < b->cost());
               });
 
-    float                       max_slack     = -1E+30F;
-    float                       max_cost      = -1E+30F;
-    std::shared_ptr<BufferTree> max_tree      = nullptr;
-    auto                        inst          = handler.instance(driver_pin);
-    auto                        original_lib  = handler.libraryCell(inst);
-    auto                        original_cost = handler.area(original_lib);
-    auto                        original_libs_set =
+    float       max_slack     = -1E+30F;
+    float       max_cost      = -1E+30F;
+    BufferTree* max_tree      = nullptr;
+    auto        inst          = handler.instance(driver_pin);
+    auto        original_lib  = handler.libraryCell(inst);
+    auto        original_cost = handler.area(original_lib);
+    auto        original_libs_set =
         handler.truthTableToCells(handler.cellToTruthTable(original_lib));
     auto  original_libs = std::vector<LibraryCell*>(original_libs_set.begin(),
                                                    original_libs_set.end());
@@ -1081,7 +1227,7 @@ BufferSolution::optimalDriverTreeWithResynthesis(Psn*          psn_inst,
     return max_tree;
 }
 
-std::shared_ptr<BufferTree>
+BufferTree*
 BufferSolution::optimalTimerlessDriverTree(Psn*          psn_inst,
                                            InstanceTerm* driver_pin)
 {
@@ -1090,8 +1236,7 @@ BufferSolution::optimalTimerlessDriverTree(Psn*          psn_inst,
         return nullptr;
     }
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [&](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [&](const BufferTree* a, const BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
     float slew_limit = psn_inst->handler()->pinSlewLimit(driver_pin);
@@ -1109,35 +1254,48 @@ BufferSolution::optimalTimerlessDriverTree(Psn*          psn_inst,
     }
     return buffer_trees_[0];
 }
-std::shared_ptr<BufferTree>
+BufferTree*
 BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                                  std::shared_ptr<BufferTree>& inverted_sol,
-                                  float*                       tree_slack)
+                                  BufferTree*& inverted_sol, float* tree_slack)
 {
     if (!buffer_trees_.size())
     {
         return nullptr;
     }
 
-    auto first_tree = buffer_trees_[0];
-    std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [&](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
-                  float a_delay = psn_inst->handler()->gateDelay(
-                      driver_pin, a->totalCapacitance());
-                  float a_slack = a->totalRequiredOrSlew() - a_delay;
-                  float b_delay = psn_inst->handler()->gateDelay(
-                      driver_pin, b->totalCapacitance());
-                  float b_slack = b->totalRequiredOrSlew() - b_delay;
-                  return a_slack > b_slack ||
-                         (isEqual(a_slack, b_slack, 1E-6F) &&
-                          a->cost() < b->cost());
-              });
+    DatabaseHandler&    handler = *(psn_inst->handler());
+    size_t              count   = buffer_trees_.size();
+    std::vector<float>  caps(count), slacks(count);
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        caps[i]  = buffer_trees_[i]->totalCapacitance();
+        order[i] = i;
+    }
+    handler.gateDelays(handler.libraryPin(driver_pin), caps.data(),
+                       slacks.data(), nullptr, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        slacks[i] = buffer_trees_[i]->totalRequiredOrSlew() - slacks[i];
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) -> bool {
+        return slacks[a] > slacks[b] ||
+               (isEqual(slacks[a], slacks[b], 1E-6F) &&
+                buffer_trees_[a]->cost() < buffer_trees_[b]->cost());
+    });
+
+    std::vector<BufferTree*> sorted_trees(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        sorted_trees[i] = buffer_trees_[order[i]];
+    }
+    buffer_trees_.swap(sorted_trees);
 
-    float                       max_slack = -1E+30F;
-    std::shared_ptr<BufferTree> max_tree  = nullptr;
-    for (auto& tree : buffer_trees_)
+    float       max_slack = -1E+30F;
+    BufferTree* max_tree  = nullptr;
+    for (size_t i = 0; i < count; i++)
     {
+        auto tree = buffer_trees_[i];
         if (tree->polarity())
         {
             if (inverted_sol == nullptr)
@@ -1146,9 +1304,7 @@ BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
             }
             continue;
         }
-        float delay = psn_inst->handler()->gateDelay(driver_pin,
-                                                     tree->totalCapacitance());
-        float slack = tree->totalRequiredOrSlew() - delay;
+        float slack = slacks[order[i]];
 
         if (isGreater(slack, max_slack))
         {
@@ -1163,10 +1319,11 @@ BufferSolution::optimalDriverTree(Psn* psn_inst, InstanceTerm* driver_pin,
     }
     return max_tree;
 }
-std::shared_ptr<BufferTree>
-BufferSolution::optimalCapacitanceTree(
-    Psn* psn_inst, InstanceTerm* driver_pin,
-    std::shared_ptr<BufferTree>& inverted_sol, float cap_limit)
+BufferTree*
+BufferSolution::optimalCapacitanceTree(Psn*          psn_inst,
+                                       InstanceTerm* driver_pin,
+                                       BufferTree*& inverted_sol,
+                                       float        cap_limit)
 {
     if (!buffer_trees_.size())
     {
@@ -1175,12 +1332,11 @@ BufferSolution::optimalCapacitanceTree(
 
     auto first_tree = buffer_trees_[0];
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [&](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [&](const BufferTree* a, const BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
 
-    std::shared_ptr<BufferTree> max_tree = nullptr;
+    BufferTree* max_tree = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (tree->totalCapacitance() < cap_limit)
@@ -1191,10 +1347,9 @@ BufferSolution::optimalCapacitanceTree(
     }
     return max_tree;
 }
-std::shared_ptr<BufferTree>
+BufferTree*
 BufferSolution::optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                                std::shared_ptr<BufferTree>& inverted_sol,
-                                float                        slew_limit)
+                                BufferTree*& inverted_sol, float slew_limit)
 {
     if (!buffer_trees_.size())
     {
@@ -1204,12 +1359,11 @@ BufferSolution::optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
 
     auto first_tree = buffer_trees_[0];
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [&](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [&](const BufferTree* a, const BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
 
-    std::shared_ptr<BufferTree> max_tree = nullptr;
+    BufferTree* max_tree = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (handler.slew(handler.libraryPin(driver_pin),
@@ -1222,10 +1376,10 @@ BufferSolution::optimalSlewTree(Psn* psn_inst, InstanceTerm* driver_pin,
     return max_tree;
 }
 
-std::shared_ptr<BufferTree>
+BufferTree*
 BufferSolution::optimalCostTree(Psn* psn_inst, InstanceTerm* driver_pin,
-                                std::shared_ptr<BufferTree>& inverted_sol,
-                                float slew_limit, float cap_limit)
+                                BufferTree*& inverted_sol, float slew_limit,
+                                float cap_limit)
 {
     if (!buffer_trees_.size())
     {
@@ -1235,15 +1389,14 @@ BufferSolution::optimalCostTree(Psn* psn_inst, InstanceTerm* driver_pin,
 
     auto first_tree = buffer_trees_[0];
     std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-              [&](const std::shared_ptr<BufferTree>& a,
-                  const std::shared_ptr<BufferTree>& b) -> bool {
+              [&](const BufferTree* a, const BufferTree* b) -> bool {
                   return a->cost() < b->cost();
               });
 
-    std::shared_ptr<BufferTree> max_tree  = nullptr;
-    float                       max_slack = -1E+30F;
-    size_t                      i         = 0;
-    std::shared_ptr<BufferTree> second_best;
+    BufferTree* max_tree    = nullptr;
+    float       max_slack   = -1E+30F;
+    size_t      i           = 0;
+    BufferTree* second_best = nullptr;
     for (auto& tree : buffer_trees_)
     {
         if (tree->polarity())
@@ -1323,110 +1476,317 @@ void
 BufferSolution::prune(Psn* psn_inst, LibraryCell* upstream_res_cell,
                       float       minimum_upstream_res_or_max_slew,
                       const float cap_prune_threshold,
-                      const float cost_prune_threshold)
+                      const float cost_prune_threshold, bool squeeze_pruning,
+                      size_t max_candidates)
+{
+    candidates_.clear();
+    candidates_.reserve(buffer_trees_.size());
+    for (auto& tree : buffer_trees_)
+    {
+        candidates_.add(tree);
+    }
+    approximation_loss_ += pruneCandidates(
+        psn_inst, upstream_res_cell, minimum_upstream_res_or_max_slew,
+        cap_prune_threshold, cost_prune_threshold, squeeze_pruning,
+        max_candidates);
+    materializeCandidates(psn_inst, Point(0, 0));
+}
+float
+BufferSolution::approximationLoss() const
 {
+    return approximation_loss_;
+}
+// Pareto staircase of (key, value) points that answers the minimum value among
+// the inserted points with a key not exceeding a bound in O(log n).
+class MinimumValueStaircase
+{
+    std::map<float, float> steps_; // Increasing keys with decreasing values
+
+public:
+    bool
+    minimum(float bound, float& value) const
+    {
+        auto it = steps_.upper_bound(bound);
+        if (it == steps_.begin())
+        {
+            return false;
+        }
+        value = (--it)->second;
+        return true;
+    }
+    void
+    insert(float key, float value)
+    {
+        float current;
+        if (minimum(key, current) && current <= value)
+        {
+            return;
+        }
+        auto it = steps_.insert(std::make_pair(key, value)).first;
+        it->second = value;
+        ++it;
+        while (it != steps_.end() && it->second >= value)
+        {
+            it = steps_.erase(it);
+        }
+    }
+};
+
+float
+BufferSolution::pruneCandidates(Psn* psn_inst, LibraryCell* upstream_res_cell,
+                                float       minimum_upstream_res_or_max_slew,
+                                const float cap_prune_threshold,
+                                const float cost_prune_threshold,
+                                bool squeeze_pruning, size_t max_candidates)
+{
+    auto&               cap  = candidates_.capacitance;
+    auto&               req  = candidates_.required_or_slew;
+    auto&               cost = candidates_.cost;
+    std::vector<size_t> order(candidates_.size());
+    std::vector<size_t> kept;
+    kept.reserve(order.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    // A candidate is dropped when an already kept candidate is not worse in
+    // both keys, the staircase bound includes the fuzzy comparison margin.
     if (!isTimerless()) // Timing-driven
     {
-        // TODO Add squeeze pruning
         if (!upstream_res_cell)
         {
             PSN_LOG_WARN("Pruning without upstream resistance");
-            return;
+            return 0.0;
         }
-
-        std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                  [&](const std::shared_ptr<BufferTree>& a,
-                      const std::shared_ptr<BufferTree>& b) -> bool {
-                      float left_req =
-                          a->bufferRequired(psn_inst, upstream_res_cell);
-                      float right_req =
-                          b->bufferRequired(psn_inst, upstream_res_cell);
-                      return left_req > right_req;
+        DatabaseHandler&   handler = *(psn_inst->handler());
+        std::vector<float> buffer_req(candidates_.size());
+        handler.bufferDelays(upstream_res_cell, cap.data(), buffer_req.data(),
+                             buffer_req.size());
+        for (size_t i = 0; i < buffer_req.size(); i++)
+        {
+            buffer_req[i] = req[i] - buffer_req[i];
+        }
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) -> bool {
+                      return buffer_req[a] > buffer_req[b] ||
+                             (buffer_req[a] == buffer_req[b] && a < b);
                   });
 
-        size_t index = 0;
-        for (size_t i = 0; i < buffer_trees_.size(); i++)
+        // Keep the candidates with lower capacitance or lower cost than all
+        // the candidates with higher upstream required time.
+        MinimumValueStaircase cap_cost;
+        for (auto j : order)
         {
-            index = i + 1;
-            for (size_t j = i + 1; j < buffer_trees_.size(); j++)
+            float min_cost;
+            if (cap_cost.minimum(cap[j] / (1.0F - cap_prune_threshold),
+                                 min_cost) &&
+                !isLess(cost[j], min_cost, cost_prune_threshold))
             {
-                if (isLess(buffer_trees_[j]->totalCapacitance(),
-                           buffer_trees_[i]->totalCapacitance(),
-                           cap_prune_threshold) ||
-                    isLess(buffer_trees_[j]->cost(), buffer_trees_[i]->cost(),
-                           cost_prune_threshold))
-                {
-                    buffer_trees_[index++] = buffer_trees_[j];
-                }
+                continue;
             }
-            buffer_trees_.resize(index);
+            kept.push_back(j);
+            cap_cost.insert(cap[j], cost[j]);
         }
         if (minimum_upstream_res_or_max_slew)
         {
-            std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                      [](const std::shared_ptr<BufferTree>& a,
-                         const std::shared_ptr<BufferTree>& b) -> bool {
-                          return a->totalRequiredOrSlew() <
-                                 b->totalRequiredOrSlew();
+            order.swap(kept);
+            kept.clear();
+            std::sort(order.begin(), order.end(),
+                      [&](size_t a, size_t b) -> bool {
+                          return req[a] < req[b] || (req[a] == req[b] && a < b);
                       });
-
-            index = 0;
-            for (size_t i = 0; i < buffer_trees_.size(); i++)
+            // Drop the candidates whose required time gain over a lower
+            // capacitance candidate does not pay for the extra capacitance
+            // through the minimum upstream resistance, i.e. the candidates
+            // with a lower req - R * cap than a kept lower capacitance one.
+            MinimumValueStaircase cap_gain;
+            for (auto j : order)
             {
-                index = i + 1;
-                for (size_t j = i + 1; j < buffer_trees_.size(); j++)
+                float loss =
+                    minimum_upstream_res_or_max_slew * cap[j] - req[j];
+                float min_loss;
+                if (cap_gain.minimum(cap[j] * (1.0F - cap_prune_threshold),
+                                     min_loss) &&
+                    min_loss < loss)
                 {
-                    if (isGreaterOrEqual(buffer_trees_[i]->totalCapacitance(),
-                                         buffer_trees_[j]->totalCapacitance(),
-                                         cap_prune_threshold) ||
-                        !((buffer_trees_[j]->totalRequiredOrSlew() -
-                           buffer_trees_[i]->totalRequiredOrSlew()) /
-                              (buffer_trees_[j]->totalCapacitance() -
-                               buffer_trees_[i]->totalCapacitance()) <
-                          minimum_upstream_res_or_max_slew))
-                    {
-                        buffer_trees_[index++] = buffer_trees_[j];
-                    }
+                    continue;
                 }
-                buffer_trees_.resize(index);
+                kept.push_back(j);
+                cap_gain.insert(cap[j], loss);
             }
         }
+        if (squeeze_pruning)
+        {
+            squeezeCandidates(kept, minimum_upstream_res_or_max_slew);
+        }
     }
     else
     {
-        buffer_trees_.erase(
-            std::remove_if(buffer_trees_.begin(), buffer_trees_.end(),
-                           [&](const std::shared_ptr<BufferTree>& t) -> bool {
-                               return isGreaterOrEqual(
-                                   t->totalRequiredOrSlew(),
-                                   minimum_upstream_res_or_max_slew,
-                                   cap_prune_threshold);
-                           }),
-            buffer_trees_.end());
-        std::sort(buffer_trees_.begin(), buffer_trees_.end(),
-                  [](const std::shared_ptr<BufferTree>& a,
-                     const std::shared_ptr<BufferTree>& b) -> bool {
-                      return a->cost() < b->cost();
+        order.erase(std::remove_if(order.begin(), order.end(),
+                                   [&](size_t i) -> bool {
+                                       return isGreaterOrEqual(
+                                           req[i],
+                                           minimum_upstream_res_or_max_slew,
+                                           cap_prune_threshold);
+                                   }),
+                    order.end());
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) -> bool {
+                      return cost[a] < cost[b] || (cost[a] == cost[b] && a < b);
                   });
-        size_t index = 0;
-        for (size_t i = 0; i < buffer_trees_.size(); i++)
+        // Keep the candidates with lower slew or lower capacitance than all
+        // the lower cost candidates.
+        MinimumValueStaircase slew_cap;
+        for (auto j : order)
         {
-            index = i + 1;
-            for (size_t j = i + 1; j < buffer_trees_.size(); j++)
+            float min_cap;
+            if (slew_cap.minimum(req[j] / (1.0F - cap_prune_threshold),
+                                 min_cap) &&
+                !isLess(cap[j], min_cap, cap_prune_threshold))
             {
-                if ((isLess(buffer_trees_[j]->totalRequiredOrSlew(),
-                            buffer_trees_[i]->totalRequiredOrSlew(),
-                            cap_prune_threshold) ||
-                     isLess(buffer_trees_[j]->totalCapacitance(),
-                            buffer_trees_[i]->totalCapacitance(),
-                            cap_prune_threshold)))
-                {
-                    buffer_trees_[index++] = buffer_trees_[j];
-                }
+                continue;
+            }
+            kept.push_back(j);
+            slew_cap.insert(req[j], cap[j]);
+        }
+    }
+    float loss = limitCandidates(kept, max_candidates);
+    candidates_.select(kept);
+    return loss;
+}
+void
+BufferSolution::squeezeCandidates(std::vector<size_t>& order,
+                                  float                minimum_upstream_res)
+{
+    auto& cap  = candidates_.capacitance;
+    auto& req  = candidates_.required_or_slew;
+    auto& cost = candidates_.cost;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) -> bool {
+        return cap[a] < cap[b] ||
+               (cap[a] == cap[b] && (req[a] > req[b] ||
+                                     (req[a] == req[b] && a < b)));
+    });
+    // Drop the candidates under the upper convex hull of the (capacitance,
+    // required time) front, whatever the upstream resistance they are never
+    // better than the two hull candidates around them.
+    std::vector<size_t> hull;
+    hull.reserve(order.size());
+    for (auto c : order)
+    {
+        while (hull.size() > 1)
+        {
+            size_t a = hull[hull.size() - 2];
+            size_t b = hull.back();
+            float  turn =
+                (cap[b] - cap[a]) * (req[c] - req[a]) -
+                (req[b] - req[a]) * (cap[c] - cap[a]);
+            if (turn < 0.0)
+            {
+                break;
+            }
+            hull.pop_back();
+        }
+        hull.push_back(c);
+    }
+    // The upstream resistance is at least minimum_upstream_res, a hull
+    // candidate is dominated by a lower capacitance one with a higher
+    // req - R * cap at that resistance.
+    std::vector<char> on_hull(cap.size(), 0);
+    float             best = -std::numeric_limits<float>::infinity();
+    for (auto c : hull)
+    {
+        float value = req[c] - minimum_upstream_res * cap[c];
+        if (value > best)
+        {
+            on_hull[c] = 1;
+            best       = value;
+        }
+    }
+    // The minimum-cost buffering selects among the cheapest candidates, a
+    // pruned candidate is still kept when it is cheaper than all the kept
+    // lower capacitance candidates.
+    std::vector<size_t> kept;
+    kept.reserve(order.size());
+    float min_cost = std::numeric_limits<float>::infinity();
+    for (auto c : order)
+    {
+        if (on_hull[c] || cost[c] < min_cost)
+        {
+            kept.push_back(c);
+            min_cost = std::min(min_cost, cost[c]);
+        }
+    }
+    order.swap(kept);
+}
+float
+BufferSolution::limitCandidates(std::vector<size_t>& order,
+                                size_t               max_candidates)
+{
+    if (!max_candidates || order.size() <= max_candidates)
+    {
+        return 0.0;
+    }
+    // The two ends of the front are always kept.
+    max_candidates = std::max(max_candidates, size_t(2));
+    auto& cap      = candidates_.capacitance;
+    auto& req      = candidates_.required_or_slew;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) -> bool {
+        return cap[a] < cap[b] || (cap[a] == cap[b] && a < b);
+    });
+    // Keep evenly spaced candidates along the capacitance axis, the loss of a
+    // dropped candidate is its required time (or slew) difference with the
+    // best kept candidate with a lower capacitance.
+    size_t              n    = order.size();
+    size_t              step = max_candidates - 1;
+    size_t              next = 0;
+    float               best = 0.0;
+    float               loss = 0.0;
+    std::vector<size_t> kept;
+    kept.reserve(max_candidates);
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t j = order[i];
+        if (i == (next * (n - 1) + step / 2) / step)
+        {
+            best = kept.empty() ? req[j]
+                                : (isTimerless() ? std::min(best, req[j])
+                                                 : std::max(best, req[j]));
+            kept.push_back(j);
+            next++;
+        }
+        else
+        {
+            loss = std::max(loss, isTimerless() ? best - req[j]
+                                                : req[j] - best);
+        }
+    }
+    order.swap(kept);
+    return loss;
+}
+void
+BufferSolution::materializeCandidates(Psn* psn_inst, Point location)
+{
+    buffer_trees_.resize(candidates_.size());
+    for (size_t i = 0; i < candidates_.size(); i++)
+    {
+        if (!candidates_.tree[i])
+        {
+            auto left_branch  = candidates_.left[i];
+            auto right_branch = candidates_.right[i];
+            if (isTimerless())
+            {
+                candidates_.tree[i] = arena_->createTimerless(
+                    psn_inst, left_branch, right_branch, location);
+            }
+            else
+            {
+                candidates_.tree[i] = arena_->create(psn_inst, left_branch,
+                                                     right_branch, location);
             }
-            buffer_trees_.resize(index);
         }
+        buffer_trees_[i] = candidates_.tree[i];
     }
+    candidates_.clear();
 }
 void
 BufferSolution::setMode(BufferMode buffer_mode)
@@ -1446,17 +1806,18 @@ BufferSolution::isTimerless() const
     return mode_ == BufferMode::Timerless;
 }
 
-TimerlessBufferSolution::TimerlessBufferSolution()
-    : BufferSolution(BufferMode::Timerless)
+TimerlessBufferSolution::TimerlessBufferSolution(BufferTreeArena& arena)
+    : BufferSolution(arena, BufferMode::Timerless)
 {
 }
 TimerlessBufferSolution::TimerlessBufferSolution(
     Psn* psn_inst, std::shared_ptr<BufferSolution>& left,
     std::shared_ptr<BufferSolution>& right, Point location,
     LibraryCell* upstream_res_cell, float minimum_upstream_res_or_max_slew,
-    BufferMode buffer_mode)
+    BufferMode buffer_mode, bool squeeze_pruning, size_t max_candidates)
     : BufferSolution(psn_inst, left, right, location, upstream_res_cell,
-                     minimum_upstream_res_or_max_slew, BufferMode::Timerless)
+                     minimum_upstream_res_or_max_slew, BufferMode::Timerless,
+                     squeeze_pruning, max_candidates)
 {
 }
 
@@ -1464,71 +1825,12 @@ std::shared_ptr<BufferSolution>
 BufferSolution::bottomUp(Psn* psn_inst, InstanceTerm* driver_pin,
                          SteinerPoint pt, SteinerPoint prev,
                          std::shared_ptr<SteinerTree>          st_tree,
-                         std::unique_ptr<OptimizationOptions>& options)
+                         std::unique_ptr<OptimizationOptions>& options,
+                         BufferTreeArena&                      arena,
+                         const SinkTimingSnapshot*             sinks)
 {
-    DatabaseHandler& handler = *(psn_inst->handler());
-    if (pt != SteinerNull)
-    {
-        auto  pt_pin        = st_tree->pin(pt);
-        float wire_length   = handler.dbuToMeters(st_tree->distance(prev, pt));
-        float wire_res      = wire_length * handler.resistancePerMicron();
-        float wire_cap      = wire_length * handler.capacitancePerMicron();
-        auto  location      = st_tree->location(pt);
-        auto  prev_location = st_tree->location(prev);
-        PSN_LOG_DEBUG("Bottomup Point: ({}, {})", location.getX(),
-                      location.getY());
-        PSN_LOG_TRACE("Prev: ({}, {})", prev_location.getX(),
-                      prev_location.getY());
-
-        if (pt_pin && handler.isLoad(pt_pin))
-        {
-            PSN_LOG_TRACE("{} ({}, {}) bottomUp leaf", handler.name(pt_pin),
-                          location.getX(), location.getY());
-            float                       cap = handler.pinCapacitance(pt_pin);
-            float                       req = handler.required(pt_pin);
-            std::shared_ptr<BufferTree> base_buffer_tree =
-                std::make_shared<BufferTree>(cap, req, 0, location,
-                                             handler.libraryPin(driver_pin),
-                                             pt_pin);
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>();
-            buff_sol->addTree(base_buffer_tree);
-
-            buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
-
-            buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
-                                   options->buffer_lib, options->inverter_lib);
-            buff_sol->addUpstreamReferences(psn_inst, base_buffer_tree);
-
-            return buff_sol;
-        }
-        else if (!pt_pin)
-        {
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> left", location.getX(),
-                          location.getY());
-            auto left = bottomUp(psn_inst, driver_pin, st_tree->left(pt), pt,
-                                 st_tree, options);
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> right", location.getX(),
-                          location.getY());
-            auto right = bottomUp(psn_inst, driver_pin, st_tree->right(pt), pt,
-                                  st_tree, options);
-
-            PSN_LOG_TRACE("({}, {}) bottomUp merging", location.getX(),
-                          location.getY());
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>(
-                    psn_inst, left, right, location,
-                    options->buffer_lib[options->buffer_lib.size() / 2],
-                    options->minimum_upstream_resistance);
-
-            buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
-            buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
-                                   options->buffer_lib, options->inverter_lib);
-
-            return buff_sol;
-        }
-    }
-    return nullptr;
+    return bottomUpTraversal(psn_inst, driver_pin, pt, prev, st_tree.get(),
+                             options, nullptr, arena, sinks);
 }
 
 std::shared_ptr<BufferSolution>
@@ -1536,78 +1838,145 @@ BufferSolution::bottomUpWithResynthesis(
     Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt, SteinerPoint prev,
     std::shared_ptr<SteinerTree>                          st_tree,
     std::unique_ptr<OptimizationOptions>&                 options,
-    std::vector<std::shared_ptr<LibraryCellMappingNode>>& mapping_terminals)
+    std::vector<std::shared_ptr<LibraryCellMappingNode>>& mapping_terminals,
+    BufferTreeArena&                                      arena)
+{
+    return bottomUpTraversal(psn_inst, driver_pin, pt, prev, st_tree.get(),
+                             options, &mapping_terminals, arena, nullptr);
+}
+
+std::shared_ptr<BufferSolution>
+BufferSolution::bottomUpTraversal(
+    Psn* psn_inst, InstanceTerm* driver_pin, SteinerPoint pt, SteinerPoint prev,
+    SteinerTree*                                          st_tree,
+    std::unique_ptr<OptimizationOptions>&                 options,
+    std::vector<std::shared_ptr<LibraryCellMappingNode>>* mapping_terminals,
+    BufferTreeArena& arena, const SinkTimingSnapshot* sinks)
 {
     DatabaseHandler& handler = *(psn_inst->handler());
-    if (pt != SteinerNull)
+    struct BottomUpFrame
+    {
+        SteinerPoint pt;
+        SteinerPoint prev;
+        bool         merge; // Both children solutions are on the stack
+    };
+    // Only the solutions of the visited points whose parent is not merged yet
+    // are alive, children solutions are released right after the merge.
+    std::vector<BottomUpFrame>                   frames;
+    std::vector<std::shared_ptr<BufferSolution>> solutions;
+    frames.push_back({pt, prev, false});
+    while (!frames.empty())
     {
-        auto  pt_pin        = st_tree->pin(pt);
-        float wire_length   = handler.dbuToMeters(st_tree->distance(prev, pt));
+        auto frame = frames.back();
+        frames.pop_back();
+        if (frame.pt == SteinerNull)
+        {
+            solutions.push_back(nullptr);
+            continue;
+        }
+        auto pt_pin   = st_tree->pin(frame.pt);
+        auto location = st_tree->location(frame.pt);
+        if (!frame.merge)
+        {
+            PSN_LOG_DEBUG("Bottomup Point: ({}, {})", location.getX(),
+                          location.getY());
+            PSN_LOG_TRACE("Prev: ({}, {})",
+                          st_tree->location(frame.prev).getX(),
+                          st_tree->location(frame.prev).getY());
+            if (!pt_pin)
+            {
+                PSN_LOG_TRACE("({}, {}) bottomUp ---> left, right",
+                              location.getX(), location.getY());
+                frames.push_back({frame.pt, frame.prev, true});
+                frames.push_back({st_tree->right(frame.pt), frame.pt, false});
+                frames.push_back({st_tree->left(frame.pt), frame.pt, false});
+                continue;
+            }
+        }
+        // The starting point is the last one on the stack.
+        bool  resynthesis = mapping_terminals && frames.empty();
+        float wire_length =
+            handler.dbuToMeters(st_tree->distance(frame.prev, frame.pt));
         float wire_res      = wire_length * handler.resistancePerMicron();
         float wire_cap      = wire_length * handler.capacitancePerMicron();
-        auto  location      = st_tree->location(pt);
-        auto  prev_location = st_tree->location(prev);
-        PSN_LOG_DEBUG("Bottomup Point: ({}, {})", location.getX(),
-                      location.getY());
-        PSN_LOG_TRACE("Prev: ({}, {})", prev_location.getX(),
-                      prev_location.getY());
+        auto  prev_location = st_tree->location(frame.prev);
 
+        std::shared_ptr<BufferSolution> buff_sol;
         if (pt_pin && handler.isLoad(pt_pin))
         {
             PSN_LOG_TRACE("{} ({}, {}) bottomUp leaf", handler.name(pt_pin),
                           location.getX(), location.getY());
-            float                       cap = handler.pinCapacitance(pt_pin);
-            float                       req = handler.required(pt_pin);
-            std::shared_ptr<BufferTree> base_buffer_tree =
-                std::make_shared<BufferTree>(cap, req, 0, location,
-                                             handler.libraryPin(driver_pin),
-                                             pt_pin);
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>();
+            float cap, req;
+            if (sinks)
+            {
+                auto& sink = sinks->at(pt_pin);
+                cap        = sink.capacitance;
+                req        = sink.required;
+            }
+            else
+            {
+                cap = handler.pinCapacitance(pt_pin);
+                req = handler.required(pt_pin);
+            }
+            BufferTree* base_buffer_tree =
+                arena.create(cap, req, 0, location,
+                             handler.libraryPin(driver_pin), pt_pin);
+            buff_sol = std::make_shared<BufferSolution>(arena);
             buff_sol->addTree(base_buffer_tree);
 
             buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
 
-            buff_sol->addLeafTreesWithResynthesis(
-                psn_inst, driver_pin, prev_location, options->buffer_lib,
-                options->inverter_lib, mapping_terminals);
+            if (resynthesis)
+            {
+                buff_sol->addLeafTreesWithResynthesis(
+                    psn_inst, driver_pin, prev_location, options->buffer_lib,
+                    options->inverter_lib, *mapping_terminals);
+            }
+            else
+            {
+                buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
+                                       options->buffer_lib,
+                                       options->inverter_lib);
+            }
             buff_sol->addUpstreamReferences(psn_inst, base_buffer_tree);
-
-            return buff_sol;
         }
         else if (!pt_pin)
         {
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> left", location.getX(),
-                          location.getY());
-            auto left = bottomUp(psn_inst, driver_pin, st_tree->left(pt), pt,
-                                 st_tree, options);
-            PSN_LOG_TRACE("({}, {}) bottomUp ---> right", location.getX(),
-                          location.getY());
-            auto right = bottomUp(psn_inst, driver_pin, st_tree->right(pt), pt,
-                                  st_tree, options);
+            auto right = std::move(solutions.back());
+            solutions.pop_back();
+            auto left = std::move(solutions.back());
+            solutions.pop_back();
 
             PSN_LOG_TRACE("({}, {}) bottomUp merging", location.getX(),
                           location.getY());
-            std::shared_ptr<BufferSolution> buff_sol =
-                std::make_shared<BufferSolution>(
-                    psn_inst, left, right, location,
-                    options->buffer_lib[options->buffer_lib.size() / 2],
-                    options->minimum_upstream_resistance);
+            buff_sol = std::make_shared<BufferSolution>(
+                psn_inst, left, right, location,
+                options->buffer_lib[options->buffer_lib.size() / 2],
+                options->minimum_upstream_resistance, BufferMode::TimingDriven,
+                options->squeeze_pruning, options->max_buffer_candidates);
 
             buff_sol->addWireDelayAndCapacitance(wire_res, wire_cap);
-            buff_sol->addLeafTreesWithResynthesis(
-                psn_inst, driver_pin, prev_location, options->buffer_lib,
-                options->inverter_lib, mapping_terminals);
-
-            return buff_sol;
+            if (resynthesis)
+            {
+                buff_sol->addLeafTreesWithResynthesis(
+                    psn_inst, driver_pin, prev_location, options->buffer_lib,
+                    options->inverter_lib, *mapping_terminals);
+            }
+            else
+            {
+                buff_sol->addLeafTrees(psn_inst, driver_pin, prev_location,
+                                       options->buffer_lib,
+                                       options->inverter_lib);
+            }
         }
+        solutions.push_back(std::move(buff_sol));
     }
-    return nullptr;
+    return solutions.back();
 }
 
 void
-BufferSolution::topDown(Psn* psn_inst, InstanceTerm* pin,
-                        std::shared_ptr<BufferTree> tree, float& area,
+BufferSolution::topDown(Psn* psn_inst, InstanceTerm* pin, BufferTree* tree,
+                        float& area,
                         int& net_index, int& buff_index,
                         std::unordered_set<Instance*>& added_buffers,
                         std::unordered_set<Net*>&      affected_nets)
@@ -1625,8 +1994,8 @@ BufferSolution::topDown(Psn* psn_inst, InstanceTerm* pin,
             affected_nets);
 }
 void
-BufferSolution::topDown(Psn* psn_inst, Net* net,
-                        std::shared_ptr<BufferTree> tree, float& area,
+BufferSolution::topDown(Psn* psn_inst, Net* net, BufferTree* tree,
+                        float& area,
                         int& net_index, int& buff_index,
                         std::unordered_set<Instance*>& added_buffers,
                         std::unordered_set<Net*>&      affected_nets)
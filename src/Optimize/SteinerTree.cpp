@@ -31,6 +31,7 @@
 
 #include "OpenPhySyn/Optimize/SteinerTree.hpp"
 #include <algorithm>
+#include <vector>
 #include "OpenPhySyn/Psn/Psn.hpp"
 #include "PsnException/SteinerException.hpp"
 namespace psn
@@ -45,8 +46,12 @@ SteinerTree::create(Net* net, Psn* psn_inst, int flute_accuracy)
     unsigned int                 pin_count = pins.size();
     if (pin_count >= 2)
     {
-        FLUTE_DTYPE* x = new FLUTE_DTYPE[pin_count];
-        FLUTE_DTYPE* y = new FLUTE_DTYPE[pin_count];
+        // Per-thread scratch coordinates, FLUTE only reads its shared LUTs
+        // once they are loaded so trees can be built concurrently.
+        static thread_local std::vector<FLUTE_DTYPE> x;
+        static thread_local std::vector<FLUTE_DTYPE> y;
+        x.resize(pin_count);
+        y.resize(pin_count);
         for (unsigned int i = 0; i < pin_count; i++)
         {
             auto  pin = pins[i];
@@ -54,13 +59,12 @@ SteinerTree::create(Net* net, Psn* psn_inst, int flute_accuracy)
             x[i]      = loc.x();
             y[i]      = loc.y();
         }
-        Flute::Tree flute_tree = Flute::flute(pin_count, x, y, flute_accuracy);
+        Flute::readLUT();
+        Flute::Tree flute_tree =
+            Flute::flute(pin_count, x.data(), y.data(), flute_accuracy);
 
         tree.reset(new SteinerTree(flute_tree, pins, psn_inst));
         tree->net_ = net;
-
-        delete[] x;
-        delete[] y;
     }
     return tree;
 }
@@ -131,6 +131,17 @@ set_max_area(float area)
     Psn::instance().handler()->setMaximumArea(area);
     return 1;
 }
+int
+set_parasitics_threads(int thread_count)
+{
+    Psn::instance().handler()->setParasiticsThreads(thread_count);
+    return 1;
+}
+int
+set_characterization_cache(const char* directory)
+{
+    return Psn::instance().handler()->setCharacterizationCache(directory);
+}
 
 float
 max_area()
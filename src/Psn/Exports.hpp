@@ -58,6 +58,8 @@ bool  has_transform(const char* transform_name);
 int   set_wire_rc(float res_per_micron, float cap_per_micron);
 int   set_wire_rc(const char* layer_name);
 int   set_max_area(float area);
+int   set_parasitics_threads(int thread_count);
+int   set_characterization_cache(const char* directory);
 float max_area();
 float core_area();
 int   link(const char* top_module);
@@ -187,6 +187,8 @@ Psn::readLib(const char* path)
         sta_->getDbNetwork()->readLibertyAfter(liberty_);
         if (liberty_)
         {
+            handler()->findCommutativeClasses(liberty_);
+            handler()->compileArcs(liberty_);
             return 1;
         }
         return -1;
@@ -452,7 +454,12 @@ Psn::runTransform(std::string transform_name, std::vector<std::string> args)
         {
 
             PSN_LOG_INFO("Invoking {} transform", transform_name);
+            // Clocks and netlist may have been edited since the last
+            // transform
+            handler()->invalidateClockNets();
+            handler()->invalidateDriverIndex();
             int rc = transforms_[transform_name]->run(this, args);
+            handler()->flushParasitics();
             PSN_LOG_INFO("Finished {} transform ({})", transform_name, rc);
             return rc;
         }
@@ -710,6 +717,8 @@ Psn::printCommands(bool raw_str)
         "violation\n"
         "transition_violations		Print pins with transition limit "
         "violation\n"
+        "set_characterization_cache	Keep the library characterization in "
+        "a cache directory shared by the following runs\n"
         "set_log				Alias for "
         "set_log_level\n"
         "set_log_level			Set log level [trace, debug, info, "
@@ -717,6 +726,8 @@ Psn::printCommands(bool raw_str)
         "set_log_pattern			Set log printing pattern, "
         "refer to spdlog logger for pattern formats\n"
         "set_max_area			Set maximum design area\n"
+        "set_parasitics_threads		Set the number of threads building the "
+        "Steiner trees of the full-design parasitics estimation\n"
         "set_wire_rc			Set wire "
         "resistance/capacitance per micron, you can also specify technology "
         "layer\n"
@@ -0,0 +1,120 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Sta/NegativeSlackPathIterator.hpp"
+#include "OpenPhySyn/Database/DatabaseHandler.hpp"
+
+#include <algorithm>
+
+namespace psn
+{
+// The heap keeps the endpoint with the smallest slack on top
+static bool
+greaterSlack(const std::pair<float, InstanceTerm*>& a,
+             const std::pair<float, InstanceTerm*>& b)
+{
+    return a.first > b.first;
+}
+
+NegativeSlackPathIterator::NegativeSlackPathIterator(
+    const DatabaseHandler*                       handler,
+    std::vector<std::pair<float, InstanceTerm*>> endpoints, size_t max_paths,
+    size_t max_depth)
+    : handler_(handler),
+      heap_(std::move(endpoints)),
+      count_(heap_.size()),
+      max_paths_(max_paths),
+      max_depth_(max_depth),
+      returned_(0)
+{
+    std::make_heap(heap_.begin(), heap_.end(), greaterSlack);
+}
+bool
+NegativeSlackPathIterator::hasNext() const
+{
+    return heap_.size() && (!max_paths_ || returned_ < max_paths_);
+}
+InstanceTerm*
+NegativeSlackPathIterator::nextEndpoint(float* slack)
+{
+    if (!hasNext())
+    {
+        return nullptr;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), greaterSlack);
+    auto endpoint = heap_.back();
+    heap_.pop_back();
+    returned_++;
+    if (slack)
+    {
+        *slack = endpoint.first;
+    }
+    return endpoint.second;
+}
+std::vector<PathPoint>
+NegativeSlackPathIterator::next()
+{
+    auto endpoint = nextEndpoint();
+    if (!endpoint)
+    {
+        return std::vector<PathPoint>();
+    }
+    auto path = handler_->worstSlackPath(endpoint);
+    // Remove clock pin
+    if (path.size())
+    {
+        path.erase(path.begin());
+    }
+    if (max_depth_ && path.size() > max_depth_)
+    {
+        path.erase(path.begin(), path.end() - max_depth_);
+    }
+    return path;
+}
+void
+NegativeSlackPathIterator::next(PathArena& paths)
+{
+    if (!hasNext())
+    {
+        return;
+    }
+    auto path = next();
+    paths.beginPath();
+    for (auto& point : path)
+    {
+        paths.addPoint(point);
+    }
+}
+size_t
+NegativeSlackPathIterator::count() const
+{
+    return count_;
+}
+} // namespace psn
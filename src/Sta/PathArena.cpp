@@ -0,0 +1,188 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Sta/PathArena.hpp"
+
+namespace psn
+{
+PathRange::PathRange(const PathPoint* first, const PathPoint* last)
+    : first_(first), last_(last)
+{
+}
+const PathPoint*
+PathRange::begin() const
+{
+    return first_;
+}
+const PathPoint*
+PathRange::end() const
+{
+    return last_;
+}
+size_t
+PathRange::size() const
+{
+    return last_ - first_;
+}
+bool
+PathRange::empty() const
+{
+    return first_ == last_;
+}
+const PathPoint&
+PathRange::operator[](size_t index) const
+{
+    return first_[index];
+}
+const PathPoint&
+PathRange::front() const
+{
+    return *first_;
+}
+const PathPoint&
+PathRange::back() const
+{
+    return *(last_ - 1);
+}
+
+PathArena::Iterator::Iterator(const PathArena* arena, size_t index)
+    : arena_(arena), index_(index)
+{
+}
+PathRange
+PathArena::Iterator::operator*() const
+{
+    return arena_->path(index_);
+}
+PathArena::Iterator&
+PathArena::Iterator::operator++()
+{
+    index_++;
+    return *this;
+}
+bool
+PathArena::Iterator::operator!=(const Iterator& other) const
+{
+    return index_ != other.index_ || arena_ != other.arena_;
+}
+
+PathArena::PathArena()
+{
+}
+void
+PathArena::reserve(size_t path_count, size_t point_count)
+{
+    offsets_.reserve(path_count);
+    points_.reserve(point_count);
+}
+void
+PathArena::clear()
+{
+    offsets_.clear();
+    points_.clear();
+}
+void
+PathArena::beginPath()
+{
+    offsets_.push_back(points_.size());
+}
+void
+PathArena::addPoint(const PathPoint& point)
+{
+    if (offsets_.empty())
+    {
+        beginPath();
+    }
+    points_.push_back(point);
+}
+void
+PathArena::addPath(const std::vector<PathPoint>& path)
+{
+    beginPath();
+    points_.insert(points_.end(), path.begin(), path.end());
+}
+void
+PathArena::truncate(size_t path_count)
+{
+    if (path_count < offsets_.size())
+    {
+        points_.resize(offsets_[path_count]);
+        offsets_.resize(path_count);
+    }
+}
+size_t
+PathArena::size() const
+{
+    return offsets_.size();
+}
+bool
+PathArena::empty() const
+{
+    return offsets_.empty();
+}
+size_t
+PathArena::pointCount() const
+{
+    return points_.size();
+}
+PathRange
+PathArena::path(size_t index) const
+{
+    size_t last =
+        index + 1 < offsets_.size() ? offsets_[index + 1] : points_.size();
+    return PathRange(points_.data() + offsets_[index], points_.data() + last);
+}
+PathRange
+PathArena::operator[](size_t index) const
+{
+    return path(index);
+}
+PathArena::Iterator
+PathArena::begin() const
+{
+    return Iterator(this, 0);
+}
+PathArena::Iterator
+PathArena::end() const
+{
+    return Iterator(this, offsets_.size());
+}
+std::vector<std::vector<PathPoint>>
+PathArena::toVectors() const
+{
+    std::vector<std::vector<PathPoint>> paths;
+    paths.reserve(size());
+    for (auto path : *this)
+    {
+        paths.push_back(std::vector<PathPoint>(path.begin(), path.end()));
+    }
+    return paths;
+}
+} // namespace psn
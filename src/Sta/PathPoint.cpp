@@ -36,11 +36,11 @@ PathPoint::PathPoint(InstanceTerm* path_pin, bool is_rise, float path_arrival,
                      float path_required, float path_slack,
                      PathAnalysisPoint* pt)
     : pin_(path_pin),
-      is_rise_(is_rise),
       arrival_(path_arrival),
       required_(path_required),
       slack_(path_slack),
-      path_ap_(pt)
+      path_ap_index_(pt ? pt->index() : -1),
+      is_rise_(is_rise)
 {
 }
 InstanceTerm*
@@ -71,16 +71,7 @@ PathPoint::slack() const
 int
 PathPoint::analysisPointIndex() const
 {
-    if (!path_ap_)
-    {
-        return -1;
-    }
-    return path_ap_->index();
-}
-PathAnalysisPoint*
-PathPoint::analysisPoint() const
-{
-    return path_ap_;
+    return path_ap_index_;
 }
 
 } // namespace psn
\ No newline at end of file
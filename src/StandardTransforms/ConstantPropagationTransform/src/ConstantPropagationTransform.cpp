@@ -63,44 +63,37 @@ ConstantPropagationTransform::isTiedToInput(Psn*          psn_inst,
                                             bool          constant_val)
 
 {
-    DatabaseHandler& handler               = *(psn_inst->handler());
-    LibraryTerm*     constant_library_term = handler.libraryPin(constant_term);
-    LibraryTerm*     input_library_term    = handler.libraryPin(input_term);
-    Instance*        inst                  = handler.instance(constant_term);
-
-    InstanceTerm* out_pin = handler.outputPins(inst)[0];
-
-    bool tied_to_input = true;
-    for (int i = 0; i < 2; ++i)
+    DatabaseHandler& handler = *(psn_inst->handler());
+    Instance*        inst    = handler.instance(constant_term);
+    InstanceTerm*    out_pin = handler.outputPins(inst)[0];
+    auto& function = handler.compiledFunction(handler.libraryPin(out_pin));
+
+    int constant_index =
+        function.inputIndex(handler.libraryPin(constant_term));
+    int input_index = function.inputIndex(handler.libraryPin(input_term));
+    if (!function.valid() || constant_index < 0 || input_index < 0)
     {
-        std::unordered_map<LibraryTerm*, int> sim_vals;
-        sim_vals[constant_library_term] = constant_val;
-        sim_vals[input_library_term]    = i;
-        if (handler.evaluateFunctionExpression(out_pin, sim_vals) != i)
-        {
-            tied_to_input = false;
-            break;
-        }
+        return 0;
     }
-
-    if (!tied_to_input)
+    uint64_t constant_bit = uint64_t(1) << constant_index;
+    uint64_t input_bit    = uint64_t(1) << input_index;
+    if (function.usedInputs() & ~(constant_bit | input_bit))
     {
-        for (int i = 0; i < 2; ++i)
-        {
-            std::unordered_map<LibraryTerm*, int> sim_vals;
-            sim_vals[constant_library_term] = constant_val;
-            sim_vals[input_library_term]    = i;
-            if (handler.evaluateFunctionExpression(out_pin, sim_vals) != !i)
-            {
-                return 0;
-            }
-        }
-        return -1;
+        // Depends on another input
+        return 0;
     }
-    else
+    uint64_t constant_bits = constant_val ? constant_bit : 0;
+    int      low_output    = function.evaluate(constant_bits);
+    int      high_output   = function.evaluate(constant_bits | input_bit);
+    if (low_output == 0 && high_output == 1)
     {
         return 1;
     }
+    else if (low_output == 1 && high_output == 0)
+    {
+        return -1;
+    }
+    return 0;
 }
 
 // 1: Tied to logic 1
@@ -111,30 +104,29 @@ ConstantPropagationTransform::isTiedToConstant(Psn*          psn_inst,
                                                InstanceTerm* constant_term,
                                                bool          constant_val)
 {
-    DatabaseHandler&           handler  = *(psn_inst->handler());
-    Instance*                  inst     = handler.instance(constant_term);
-    std::vector<InstanceTerm*> in_pins  = handler.inputPins(inst);
-    InstanceTerm*              out_pin  = handler.outputPins(inst)[0];
-    int                        last_val = -1;
-    LibraryTerm* constant_library_term  = handler.libraryPin(constant_term);
-    int          in_pin_size            = in_pins.size();
-    int          premuts                = std::pow(2, in_pin_size - 1);
-    for (int i = 0; i < premuts; ++i)
+    DatabaseHandler& handler = *(psn_inst->handler());
+    Instance*        inst    = handler.instance(constant_term);
+    InstanceTerm*    out_pin = handler.outputPins(inst)[0];
+    auto& function = handler.compiledFunction(handler.libraryPin(out_pin));
+
+    int constant_index =
+        function.inputIndex(handler.libraryPin(constant_term));
+    std::vector<uint64_t> table;
+    if (constant_index < 0 || !function.truthTable(table))
     {
-        std::unordered_map<LibraryTerm*, int> sim_vals;
-        sim_vals[constant_library_term] = constant_val;
-        int temp                        = i;
-        for (InstanceTerm* in_pin : in_pins)
+        return -1;
+    }
+    // The output is constant if it is the same for all the minterms where
+    // the constant pin holds its value
+    int    last_val = -1;
+    size_t minterms = size_t(1) << function.inputs().size();
+    for (size_t m = 0; m < minterms; m++)
+    {
+        if (((m >> constant_index) & 1) != size_t(constant_val))
         {
-            if (in_pin == constant_term)
-            {
-                continue;
-            }
-            LibraryTerm* library_pin = handler.libraryPin(in_pin);
-            sim_vals[library_pin]    = temp & 1;
-            temp >>= 1;
+            continue;
         }
-        int result = handler.evaluateFunctionExpression(out_pin, sim_vals);
+        int result = (table[m >> 6] >> (m & 63)) & 1;
         if (last_val == -1)
         {
             last_val = result;
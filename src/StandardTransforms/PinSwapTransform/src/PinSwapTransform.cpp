@@ -33,6 +33,7 @@
 #include "OpenPhySyn/Database/DatabaseHandler.hpp"
 #include "OpenPhySyn/PsnLogger/PsnLogger.hpp"
 #include "OpenPhySyn/Sta/PathPoint.hpp"
+#include "OpenPhySyn/Utils/DenseTable.hpp"
 #include "OpenPhySyn/Utils/PsnGlobal.hpp"
 #include "OpenPhySyn/Utils/StringUtils.hpp"
 #include "sta/Graph.hh"
@@ -56,9 +57,13 @@ PinSwapTransform::powerPinSwap(psn::Psn* psn_inst, int path_count)
     DatabaseHandler& handler = *(psn_inst->handler());
     PSN_LOG_WARN("This is an experimental transform that might negatively "
                  "affect your timing, use at your own risk.");
-    auto paths      = handler.bestPath(path_count);
-    int  path_index = 1;
-    for (auto& path : paths)
+    PathArena paths;
+    int       path_index = 1;
+    handler.bestPath(paths, path_count);
+
+    std::vector<InstanceTerm*> input_pins;
+    std::vector<InstanceTerm*> output_pins;
+    for (auto path : paths)
     {
         PSN_LOG_DEBUG("Optimizing path {}/{}", path_index++, paths.size());
         for (auto& point : path)
@@ -70,8 +75,8 @@ PinSwapTransform::powerPinSwap(psn::Psn* psn_inst, int path_count)
             {
                 continue;
             }
-            auto input_pins  = handler.inputPins(inst);
-            auto output_pins = handler.outputPins(inst);
+            handler.inputPins(inst, input_pins);
+            handler.outputPins(inst, output_pins);
 
             if (input_pins.size() < 2 || output_pins.size() != 1)
             {
@@ -108,10 +113,14 @@ PinSwapTransform::timingPinSwap(psn::Psn* psn_inst, int path_count)
 {
     DatabaseHandler& handler     = *(psn_inst->handler());
     auto             driver_pins = handler.levelDriverPins(true);
-    auto             cp          = handler.criticalPaths(path_count);
+    PathArena        cp;
+    DenseSet<Net*>   affected_nets;
+    handler.criticalPaths(cp, path_count);
+
+    std::vector<InstanceTerm*> fanin_pins; // Reused for every swapped driver
 
     int p_count = 0;
-    for (auto& path : cp)
+    for (auto path : cp)
     {
         PSN_LOG_DEBUG("Path {}/{}", p_count + 1, cp.size());
         p_count++;
@@ -120,12 +129,9 @@ PinSwapTransform::timingPinSwap(psn::Psn* psn_inst, int path_count)
             auto pin = pt.pin();
             if (pin && handler.isOutput(pin))
             {
-                handler.sta()->vertexRequired(handler.vertex(pin),
-                                              sta::MinMax::min());
-                handler.sta()->findDelays(handler.vertex(pin));
-                auto                     wp = handler.worstSlackPath(pin, true);
-                std::unordered_set<Net*> affected_nets;
-                auto                     driver_cell = handler.instance(pin);
+                handler.updateTiming(pin);
+                auto wp          = handler.worstSlackPath(pin, true);
+                auto driver_cell = handler.instance(pin);
 
                 if (wp.size() > 1)
                 {
@@ -140,10 +146,9 @@ PinSwapTransform::timingPinSwap(psn::Psn* psn_inst, int path_count)
 
                         for (auto& cp : commu_pins)
                         {
+                            handler.checkpoint();
                             handler.swapPins(swap_pin, cp);
-                            handler.sta()->vertexRequired(handler.vertex(pin),
-                                                          sta::MinMax::min());
-                            handler.sta()->findDelays(handler.vertex(pin));
+                            handler.updateTiming(pin);
                             auto post_swap_wp =
                                 handler.worstSlackPath(pin, true);
                             if (post_swap_wp.size())
@@ -157,22 +162,28 @@ PinSwapTransform::timingPinSwap(psn::Psn* psn_inst, int path_count)
                                 }
                                 else
                                 {
-                                    handler.swapPins(swap_pin, cp);
+                                    handler.rollback();
+                                    continue;
                                 }
                             }
+                            handler.commit();
                         }
                         if (swap_pin != inpin)
                         {
                             swap_count_++;
-                            std::vector<Net*> fanin_nets;
-                            for (auto& fpin : handler.inputPins(driver_cell))
+                            auto out_net = handler.net(pin);
+                            affected_nets.insert(handler.id(out_net), out_net);
+                            handler.inputPins(driver_cell, fanin_pins);
+                            for (auto& fpin : fanin_pins)
                             {
-                                fanin_nets.push_back(handler.net(fpin));
+                                auto fanin_net = handler.net(fpin);
+                                if (fanin_net)
+                                {
+                                    affected_nets.insert(
+                                        handler.id(fanin_net), fanin_net);
+                                }
                             }
-                            affected_nets.insert(handler.net(pin));
-                            affected_nets.insert(fanin_nets.begin(),
-                                                 fanin_nets.end());
-                            for (auto& net : affected_nets)
+                            for (auto& net : affected_nets.items())
                             {
                                 handler.calculateParasitics(net);
                             }
@@ -43,6 +43,9 @@
 #include <functional>
 #include <limits>
 #include <sstream>
+#ifdef TF_ENABLED
+#include "taskflow/taskflow.hpp"
+#endif
 
 namespace psn
 {
@@ -58,7 +61,8 @@ RepairTimingTransform::RepairTimingTransform()
       transition_violations_(0),
       capacitance_violations_(0),
       current_area_(0.0),
-      saved_slack_(0.0)
+      saved_slack_(0.0),
+      approximation_loss_(0.0)
 {
 }
 
@@ -66,13 +70,40 @@ std::unordered_set<Instance*>
 RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                                  RepairTarget                          target,
                                  std::unique_ptr<OptimizationOptions>& options)
+{
+    if (!preparePin(psn_inst, pin, options))
+    {
+        return std::unordered_set<Instance*>();
+    }
+    auto st_tree = pinSteinerTree(psn_inst, pin);
+    if (!st_tree)
+    {
+        return std::unordered_set<Instance*>();
+    }
+    auto driver_point = st_tree->driverPoint();
+    auto driver_pin   = st_tree->pin(driver_point);
+    auto top_point    = st_tree->top();
+
+    // 1. Construct candidate buffer trees without insertion (bottomUp only)
+    auto buff_sol =
+        BufferSolution::bottomUp(psn_inst, driver_pin, top_point, driver_point,
+                                 std::move(st_tree), options,
+                                 buffer_tree_arena_);
+    auto added_buffers = repairPin(psn_inst, pin, target, buff_sol, options);
+    buffer_tree_arena_.reset();
+    return added_buffers;
+}
+
+bool
+RepairTimingTransform::preparePin(Psn* psn_inst, InstanceTerm* pin,
+                                  std::unique_ptr<OptimizationOptions>& options)
 {
     DatabaseHandler& handler = *(psn_inst->handler());
     if (handler.isTopLevel(pin))
     {
         PSN_LOG_DEBUG("Top-level");
         PSN_LOG_WARN("Top-level");
-        return std::unordered_set<Instance*>();
+        return false;
     }
     auto pin_net = handler.net(pin);
 
@@ -90,10 +121,15 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
         }
         handler.ripupBuffers(fanout_buff);
     }
+    return true;
+}
 
-    // Create the Steiner tree
-    pin_net      = handler.net(pin);
-    auto st_tree = SteinerTree::create(pin_net, psn_inst);
+std::shared_ptr<SteinerTree>
+RepairTimingTransform::pinSteinerTree(Psn* psn_inst, InstanceTerm* pin)
+{
+    DatabaseHandler& handler = *(psn_inst->handler());
+    auto             pin_net = handler.net(pin);
+    auto             st_tree = SteinerTree::create(pin_net, psn_inst);
     if (!st_tree)
     {
         if (handler.connectedPins(pin_net).size() >= 2)
@@ -101,27 +137,35 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
             PSN_LOG_ERROR("Failed to create steiner tree for {}",
                           handler.name(pin));
         }
-        return std::unordered_set<Instance*>();
+        return nullptr;
     }
+    return std::move(st_tree);
+}
+
+std::unordered_set<Instance*>
+RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
+                                 RepairTarget                          target,
+                                 std::shared_ptr<BufferSolution>       buff_sol,
+                                 std::unique_ptr<OptimizationOptions>& options)
+{
+    DatabaseHandler& handler = *(psn_inst->handler());
 
     bool is_slack_repair = target == RepairTarget::RepairSlack;
     bool is_trans_repair = target == RepairTarget::RepairMaxTransition;
     bool is_cap_repair   = target == RepairTarget::RepairMaxCapacitance;
     bool is_fo_repair    = target == RepairTarget::RepairMaxFanout;
 
-    auto driver_point = st_tree->driverPoint();
-    auto driver_pin   = st_tree->pin(driver_point);
-    auto driver_cell  = handler.instance(pin);
-
-    auto top_point = st_tree->top();
+    auto driver_cell = handler.instance(pin);
 
-    std::shared_ptr<BufferSolution> buff_sol;
-    psn::LibraryCell*               replace_driver;
+    psn::LibraryCell* replace_driver;
 
-    // 1. Construct candidate buffer trees without insertion (bottomUp only)
-    buff_sol =
-        BufferSolution::bottomUp(psn_inst, driver_pin, top_point, driver_point,
-                                 std::move(st_tree), options);
+    if (buff_sol->approximationLoss() > 0.0)
+    {
+        PSN_LOG_DEBUG("Candidate limit loss for {}: {}", handler.name(pin),
+                      buff_sol->approximationLoss());
+        approximation_loss_ =
+            std::max(approximation_loss_, buff_sol->approximationLoss());
+    }
 
     std::unordered_set<Instance*> added_buffers;
     std::unordered_set<Net*>      affected_nets;
@@ -133,20 +177,17 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
         if (options->minimum_cost) // Check if minimum cost tree should be
                                    // constructed for pins with positive slack
         {
-            handler.sta()->ensureLevelized();
-            handler.sta()->vertexRequired(handler.vertex(pin),
-                                          sta::MinMax::min());
-            handler.sta()->findDelays(handler.vertex(pin));
+            handler.updateTiming(pin);
             auto wp      = handler.worstSlackPath(pin);
             use_min_cost = !is_slack_repair && wp.size() &&
                            handler.worstSlack(wp[wp.size() - 1].pin()) > 0.0;
         }
 
-        std::shared_ptr<BufferTree> buff_tree     = nullptr;
-        std::shared_ptr<BufferTree> max_req_tree  = nullptr;
-        std::shared_ptr<BufferTree> inv_buff_tree = nullptr;
-        auto                        no_buff_tree  = buff_sol->bufferTrees()[0];
-        float                       old_delay =
+        BufferTree* buff_tree     = nullptr;
+        BufferTree* max_req_tree  = nullptr;
+        BufferTree* inv_buff_tree = nullptr;
+        auto        no_buff_tree  = buff_sol->bufferTrees()[0];
+        float       old_delay =
             handler.gateDelay(pin, no_buff_tree->totalCapacitance());
         float old_slack = no_buff_tree->totalRequiredOrSlew() - old_delay;
 
@@ -272,10 +313,7 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
             if (!is_fixed && options->repair_by_pinswap &&
                 options->current_iteration == 0)
             {
-                handler.sta()->ensureLevelized();
-                handler.sta()->vertexRequired(handler.vertex(pin),
-                                              sta::MinMax::min());
-                handler.sta()->findDelays(handler.vertex(pin));
+                handler.updateTiming(pin);
                 auto wp = handler.worstSlackPath(pin, true);
                 if (wp.size() > 1)
                 {
@@ -290,11 +328,9 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
 
                         for (auto& cp : commu_pins)
                         {
+                            handler.checkpoint();
                             handler.swapPins(swap_pin, cp);
-                            handler.sta()->ensureLevelized();
-                            handler.sta()->vertexRequired(handler.vertex(pin),
-                                                          sta::MinMax::min());
-                            handler.sta()->findDelays(handler.vertex(pin));
+                            handler.updateTiming(pin);
                             auto post_swap_wp =
                                 handler.worstSlackPath(pin, true);
                             if (post_swap_wp.size())
@@ -308,23 +344,21 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                                 }
                                 else
                                 {
-                                    handler.swapPins(swap_pin, cp);
-                                    handler.sta()->search()->findAllArrivals();
-                                    handler.sta()->search()->findRequireds();
+                                    handler.rollback();
+                                    continue;
                                 }
                             }
+                            handler.commit();
                         }
                         if (swap_pin != inpin)
                         {
                             pin_swap_count_++;
-                            std::vector<Net*> fanin_nets;
-                            for (auto& fpin : handler.inputPins(driver_cell))
+                            handler.inputPins(driver_cell, fanin_pins_);
+                            for (auto& fpin : fanin_pins_)
                             {
-                                fanin_nets.push_back(handler.net(fpin));
+                                affected_nets.insert(handler.net(fpin));
                             }
                             affected_nets.insert(handler.net(pin));
-                            affected_nets.insert(fanin_nets.begin(),
-                                                 fanin_nets.end());
                             for (auto& net : affected_nets)
                             {
                                 handler.calculateParasitics(net);
@@ -344,49 +378,65 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                     handler.equivalentCells(handler.libraryCell(driver_cell));
                 float current_area    = handler.area(driver_lib);
                 auto  replaced_driver = driver_lib;
-                int   attmepts        = 0;
+                std::vector<LibraryCell*> driver_sizes;
                 for (auto& driver_size : driver_types)
                 {
                     float new_driver_area = handler.area(driver_size);
                     // Only test larger drivers for now
                     if ((new_driver_area - current_area) < buff_tree->cost() &&
-                        handler.area(driver_size) > current_area)
+                        new_driver_area > current_area)
                     {
-                        handler.replaceInstance(driver_cell, driver_size);
-                        handler.sta()->vertexRequired(handler.vertex(pin),
-                                                      sta::MinMax::min());
-                        handler.sta()->findDelays(handler.vertex(pin));
-                        is_fixed =
-                            !handler.hasElectricalViolation(
-                                pin, options->capacitance_pessimism_factor,
-                                options->transition_pessimism_factor) &&
-                            !vio_check_func(pin);
-                        replaced_driver = driver_size;
-                        attmepts++;
-                        // Only try three upsizes
-                        if (is_fixed || attmepts > 5)
-                        {
-                            if (is_fixed)
-                            {
-                                std::vector<Net*> fanin_nets;
-                                for (auto& fpin :
-                                     handler.inputPins(driver_cell))
-                                {
-                                    fanin_nets.push_back(handler.net(fpin));
-                                }
-                                affected_nets.insert(handler.net(pin));
-                                affected_nets.insert(fanin_nets.begin(),
-                                                     fanin_nets.end());
-                            }
-                            break;
-                        }
+                        driver_sizes.push_back(driver_size);
                     }
                 }
-                if (!is_fixed)
+                // The sizes are estimated without editing the netlist, the
+                // promising ones are then tried from the smallest and the
+                // first one that fixes the violation is kept
+                auto candidates =
+                    handler.evaluateSizes(driver_cell, driver_sizes);
+                candidates.erase(
+                    std::remove_if(candidates.begin(), candidates.end(),
+                                   [&](const SizingCandidate& c) -> bool {
+                                       return is_slack_repair ? c.slack < 0.0
+                                                              : !c.legal;
+                                   }),
+                    candidates.end());
+                std::stable_sort(
+                    candidates.begin(), candidates.end(),
+                    [](const SizingCandidate& a,
+                       const SizingCandidate& b) -> bool {
+                        return a.area < b.area;
+                    });
+                int attempts = 0;
+                for (auto& candidate : candidates)
                 {
-                    // Return to the original size
-                    handler.replaceInstance(driver_cell, driver_lib);
-                    replaced_driver = driver_lib;
+                    // Only try a few upsizes
+                    if (attempts++ > 5)
+                    {
+                        break;
+                    }
+                    handler.checkpoint();
+                    handler.replaceInstance(driver_cell, candidate.cell);
+                    handler.updateTiming(pin);
+                    is_fixed = !handler.hasElectricalViolation(
+                                   pin, options->capacitance_pessimism_factor,
+                                   options->transition_pessimism_factor) &&
+                               !vio_check_func(pin);
+                    if (!is_fixed)
+                    {
+                        // Return to the original size
+                        handler.rollback();
+                        continue;
+                    }
+                    handler.commit();
+                    replaced_driver = candidate.cell;
+                    handler.inputPins(driver_cell, fanin_pins_);
+                    for (auto& fpin : fanin_pins_)
+                    {
+                        affected_nets.insert(handler.net(fpin));
+                    }
+                    affected_nets.insert(handler.net(pin));
+                    break;
                 }
                 if (driver_lib != replaced_driver)
                 {
@@ -394,9 +444,7 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                     current_area_ += handler.area(replaced_driver);
                     resize_up_count_++;
                 }
-                handler.sta()->vertexRequired(handler.vertex(pin),
-                                              sta::MinMax::min());
-                handler.sta()->findDelays(handler.vertex(pin));
+                handler.updateTiming(pin);
             }
             // 5. Buffer if not fixed by resizing
             if (!is_slack_repair ||
@@ -405,7 +453,13 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
             {
                 if (!is_fixed && !options->disable_buffering)
                 {
-
+                    // The minimum cost tree is a trial, it is rolled back if
+                    // the maximum required time tree is needed instead
+                    float buffered_area = current_area_;
+                    if (options->minimum_cost)
+                    {
+                        handler.checkpoint();
+                    }
                     BufferSolution::topDown(
                         psn_inst, pin, buff_tree, current_area_, net_index_,
                         buff_index_, added_buffers, affected_nets);
@@ -416,9 +470,7 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                         handler.calculateParasitics(net);
                     }
                     affected_nets.clear();
-                    handler.sta()->vertexRequired(handler.vertex(pin),
-                                                  sta::MinMax::min());
-                    handler.sta()->findDelays(handler.vertex(pin));
+                    handler.updateTiming(pin);
                     is_fixed = !vio_check_func(pin);
                     if (options->minimum_cost)
                     {
@@ -427,8 +479,9 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                                 options->transition_pessimism_factor) &&
                             max_req_tree && max_req_tree != buff_tree)
                         {
-                            handler.ripupBuffers(added_buffers);
+                            handler.rollback();
                             added_buffers.clear();
+                            current_area_ = buffered_area;
                             buffer_count_ -= buff_tree->bufferCount();
 
                             BufferSolution::topDown(psn_inst, pin, max_req_tree,
@@ -442,11 +495,13 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                                 handler.calculateParasitics(net);
                             }
                             affected_nets.clear();
-                            handler.sta()->vertexRequired(handler.vertex(pin),
-                                                          sta::MinMax::min());
-                            handler.sta()->findDelays(handler.vertex(pin));
+                            handler.updateTiming(pin);
                             is_fixed = !vio_check_func(pin);
                         }
+                        else
+                        {
+                            handler.commit();
+                        }
                     }
                 }
             }
@@ -459,6 +514,7 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                 auto  replaced_driver = driver_lib;
                 is_fixed              = !vio_check_func(pin);
                 int attempts          = 0;
+                handler.checkpoint();
                 for (auto& driver_size : driver_types)
                 {
                     // Only test larger drivers for now
@@ -473,26 +529,27 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                         {
                             if (is_fixed)
                             {
-                                std::vector<Net*> fanin_nets;
-                                for (auto& fpin :
-                                     handler.inputPins(driver_cell))
+                                handler.inputPins(driver_cell, fanin_pins_);
+                                for (auto& fpin : fanin_pins_)
                                 {
-                                    fanin_nets.push_back(handler.net(fpin));
+                                    affected_nets.insert(handler.net(fpin));
                                 }
                                 affected_nets.insert(handler.net(pin));
-                                affected_nets.insert(fanin_nets.begin(),
-                                                     fanin_nets.end());
                             }
 
                             break;
                         }
                     }
                 }
-                if (!is_fixed && !is_slack_repair)
+                if (!is_fixed)
                 {
                     // Return to the original size
                     replaced_driver = driver_lib;
-                    handler.replaceInstance(driver_cell, driver_lib);
+                    handler.rollback();
+                }
+                else
+                {
+                    handler.commit();
                 }
                 if (driver_lib != replaced_driver)
                 {
@@ -508,13 +565,12 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
                 current_area_ -= handler.area(driver_lib);
                 current_area_ += handler.area(replace_driver);
                 resize_up_count_++;
-                std::vector<Net*> fanin_nets;
-                for (auto& fpin : handler.inputPins(driver_cell))
+                handler.inputPins(driver_cell, fanin_pins_);
+                for (auto& fpin : fanin_pins_)
                 {
-                    fanin_nets.push_back(handler.net(fpin));
+                    affected_nets.insert(handler.net(fpin));
                 }
                 affected_nets.insert(handler.net(pin));
-                affected_nets.insert(fanin_nets.begin(), fanin_nets.end());
             }
             for (auto& net : affected_nets)
             {
@@ -531,19 +587,174 @@ RepairTimingTransform::repairPin(Psn* psn_inst, InstanceTerm* pin,
     return added_buffers;
 }
 
+bool
+RepairTimingTransform::isRepairCandidate(
+    Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+    std::unique_ptr<OptimizationOptions>& options)
+{
+    DatabaseHandler& handler = *(psn_inst->handler());
+    auto             pin_net = handler.net(pin);
+    if (!pin_net || handler.isClock(pin_net) || handler.isSpecial(pin_net))
+    {
+        return false;
+    }
+    if (target == RepairTarget::RepairMaxFanout)
+    {
+        return handler.violatesMaximumFanout(pin);
+    }
+    auto vio = handler.hasElectricalViolation(
+        pin, options->capacitance_pessimism_factor,
+        options->transition_pessimism_factor);
+    if (vio == ElectircalViolation::CapacitanceAndTransition)
+    {
+        return true;
+    }
+    return target == RepairTarget::RepairMaxCapacitance
+               ? vio == ElectircalViolation::Capacitance
+               : vio == ElectircalViolation::Transition;
+}
+
+int
+RepairTimingTransform::repairPinsConcurrently(
+    Psn* psn_inst, std::vector<InstanceTerm*>& driver_pins, RepairTarget target,
+    std::unique_ptr<OptimizationOptions>& options)
+{
+    PSN_LOG_DEBUG("Building buffer candidates with {} threads",
+                  options->buffering_threads);
+    DatabaseHandler& handler         = *(psn_inst->handler());
+    int              last_edit_count = getEditCount();
+    // A few nets per thread to balance the uneven tree sizes.
+    size_t batch_size = options->buffering_threads * 4;
+
+    std::vector<InstanceTerm*>                    batch_pins;
+    std::vector<SinkTimingSnapshot>               batch_sinks(batch_size);
+    std::vector<std::shared_ptr<BufferSolution>>  batch_solutions(batch_size);
+    std::vector<std::unique_ptr<BufferTreeArena>> batch_arenas;
+    for (size_t i = 0; i < batch_size; i++)
+    {
+        batch_arenas.push_back(
+            std::unique_ptr<BufferTreeArena>(new BufferTreeArena()));
+    }
+#ifdef TF_ENABLED
+    tf::Executor executor(options->buffering_threads);
+#endif
+
+    size_t next_pin = 0;
+    while (next_pin < driver_pins.size())
+    {
+        // 1. Collect the next violating pins, the netlist edits of the
+        // optional rip-up are done serially
+        batch_pins.clear();
+        while (next_pin < driver_pins.size() && batch_pins.size() < batch_size)
+        {
+            auto pin = driver_pins[next_pin++];
+            if (isRepairCandidate(psn_inst, pin, target, options) &&
+                preparePin(psn_inst, pin, options))
+            {
+                batch_pins.push_back(pin);
+            }
+        }
+        if (batch_pins.empty())
+        {
+            break;
+        }
+
+        // 2. Capture the sink timing serially, each sink is updated up to its
+        // own level only, then construct the Steiner trees and the candidate
+        // buffer trees concurrently from the snapshots
+        for (size_t i = 0; i < batch_pins.size(); i++)
+        {
+            batch_sinks[i].clear();
+            for (auto& sink : handler.connectedPins(handler.net(batch_pins[i])))
+            {
+                if (handler.isLoad(sink))
+                {
+                    handler.updateTiming(sink);
+                    batch_sinks[i][sink] = {handler.pinCapacitance(sink),
+                                            handler.required(sink)};
+                }
+            }
+        }
+        auto build_candidates = [&](int i) {
+            auto st_tree = pinSteinerTree(psn_inst, batch_pins[i]);
+            if (!st_tree)
+            {
+                return;
+            }
+            auto driver_point  = st_tree->driverPoint();
+            batch_solutions[i] = BufferSolution::bottomUp(
+                psn_inst, st_tree->pin(driver_point), st_tree->top(),
+                driver_point, st_tree, options, *batch_arenas[i],
+                &batch_sinks[i]);
+        };
+#ifdef TF_ENABLED
+        tf::Taskflow taskflow;
+        taskflow.parallel_for(0, int(batch_pins.size()), 1, build_candidates);
+        executor.run(taskflow).wait();
+#else
+        for (size_t i = 0; i < batch_pins.size(); i++)
+        {
+            build_candidates(i);
+        }
+#endif
+
+        // 3. Commit the solutions in the driver level order, the pins fixed by
+        // the previous commits are skipped unless their buffers were ripped-up
+        bool max_area_reached = false;
+        for (size_t i = 0; i < batch_pins.size(); i++)
+        {
+            auto pin = batch_pins[i];
+            if (!max_area_reached && batch_solutions[i] &&
+                (i == 0 || options->ripup_existing_buffer_max_levels ||
+                 isRepairCandidate(psn_inst, pin, target, options)))
+            {
+                PSN_LOG_DEBUG("Fixing violations for pin {}",
+                              handler.name(pin));
+                repairPin(psn_inst, pin, target, batch_solutions[i], options);
+                if (options->legalization_frequency > 0 &&
+                    (getEditCount() - last_edit_count >=
+                     options->legalization_frequency))
+                {
+                    last_edit_count = getEditCount();
+                    handler.legalize();
+                }
+                if (handler.hasMaximumArea() &&
+                    current_area_ > handler.maximumArea())
+                {
+                    PSN_LOG_WARN("Maximum utilization reached");
+                    max_area_reached = true;
+                }
+            }
+            batch_solutions[i] = nullptr;
+            batch_arenas[i]->reset();
+        }
+        if (max_area_reached)
+        {
+            break;
+        }
+    }
+    handler.releaseThreadDelayCalculators();
+    return getEditCount();
+}
+
 int
 RepairTimingTransform::fixCapacitanceViolations(
     Psn* psn_inst, std::vector<InstanceTerm*>& driver_pins,
     std::unique_ptr<OptimizationOptions>& options)
 {
     PSN_LOG_DEBUG("Fixing capacitance violations");
+    if (options->buffering_threads > 1)
+    {
+        return repairPinsConcurrently(psn_inst, driver_pins,
+                                      RepairTarget::RepairMaxCapacitance,
+                                      options);
+    }
     DatabaseHandler& handler         = *(psn_inst->handler());
-    auto             clock_nets      = handler.clockNets();
     int              last_edit_count = getEditCount();
     for (auto& pin : driver_pins)
     {
         auto pin_net = handler.net(pin);
-        if (pin_net && !clock_nets.count(pin_net) &&
+        if (pin_net && !handler.isClock(pin_net) &&
             !handler.isSpecial(pin_net))
         {
             auto vio = handler.hasElectricalViolation(
@@ -584,13 +795,18 @@ RepairTimingTransform::fixTransitionViolations(
     PSN_LOG_DEBUG("Fixing transition violations");
     DatabaseHandler& handler = *(psn_inst->handler());
     handler.resetDelays();
-    auto clock_nets      = handler.clockNets();
-    int  last_edit_count = getEditCount();
+    if (options->buffering_threads > 1)
+    {
+        return repairPinsConcurrently(psn_inst, driver_pins,
+                                      RepairTarget::RepairMaxTransition,
+                                      options);
+    }
+    int last_edit_count = getEditCount();
     for (auto& pin : driver_pins)
     {
         auto pin_net = handler.net(pin);
 
-        if (pin_net && !clock_nets.count(pin_net) &&
+        if (pin_net && !handler.isClock(pin_net) &&
             !handler.isSpecial(pin_net))
         {
             auto vio = handler.hasElectricalViolation(
@@ -630,13 +846,17 @@ RepairTimingTransform::fixFanoutViolations(
     PSN_LOG_DEBUG("Fixing fanout violations");
     DatabaseHandler& handler = *(psn_inst->handler());
     handler.resetDelays();
-    auto clock_nets      = handler.clockNets();
-    int  last_edit_count = getEditCount();
+    if (options->buffering_threads > 1)
+    {
+        return repairPinsConcurrently(
+            psn_inst, driver_pins, RepairTarget::RepairMaxFanout, options);
+    }
+    int last_edit_count = getEditCount();
     for (auto& pin : driver_pins)
     {
         auto pin_net = handler.net(pin);
 
-        if (pin_net && !clock_nets.count(pin_net) &&
+        if (pin_net && !handler.isClock(pin_net) &&
             !handler.isSpecial(pin_net))
         {
             auto vio = handler.violatesMaximumFanout(pin);
@@ -671,34 +891,30 @@ RepairTimingTransform::fixNegativeSlack(
     std::unique_ptr<OptimizationOptions>& options)
 {
     PSN_LOG_DEBUG("Fixing negative slack violations");
-    DatabaseHandler& handler              = *(psn_inst->handler());
-    auto             negative_slack_paths = handler.getNegativeSlackPaths();
+    DatabaseHandler& handler = *(psn_inst->handler());
+    // The endpoints are streamed from the worst one, each path is expanded
+    // when it is repaired since the previous repairs change it
+    auto negative_slack_paths =
+        handler.negativeSlackPaths(options->max_negative_slack_paths);
 
-    if (!negative_slack_paths.size())
+    if (!negative_slack_paths.count())
     {
         return 0;
     }
-    PSN_LOG_INFO("Found {} negative slack paths", negative_slack_paths.size());
+    PSN_LOG_INFO("Found {} negative slack paths",
+                 negative_slack_paths.count());
 
-    int                               check_negative_slack_freq = 10;
-    std::unordered_set<InstanceTerm*> buffered_pins;
-    int                               iteration       = 0;
-    int                               last_edit_count = buffer_count_;
+    int check_negative_slack_freq = 10;
+    int iteration                 = 0;
+    int last_edit_count           = buffer_count_;
 
     // NOTE: This can be done in parallel..
     int unfixed_paths = 0;
-    for (size_t i = 0; i < negative_slack_paths.size() &&
-                       (!options->max_negative_slack_paths ||
-                        i < (size_t)options->max_negative_slack_paths);
-         i++)
+    while (negative_slack_paths.hasNext())
     {
-        int   fixed_pin_count = 0;
-        auto& pth             = negative_slack_paths[i];
-        std::reverse(pth.begin(), pth.end());
-        auto end_pin = pth[0].pin();
-        // Refresh path
-        pth                     = handler.worstSlackPath(end_pin);
-        negative_slack_paths[i] = pth;
+        int  fixed_pin_count = 0;
+        auto end_pin         = negative_slack_paths.nextEndpoint();
+        auto pth             = handler.worstSlackPath(end_pin);
         std::reverse(pth.begin(), pth.end());
         float worst_slack = handler.worstSlack(end_pin);
         float init_slack  = worst_slack;
@@ -707,8 +923,7 @@ RepairTimingTransform::fixNegativeSlack(
             if (worst_slack < 0.0)
             {
                 auto pin = pt.pin();
-                if ((!filter_pins.size() || filter_pins.count(pin)) &&
-                    !buffered_pins.count(pin))
+                if (!filter_pins.size() || filter_pins.count(pin))
                 {
                     if (handler.isAnyOutput(pin) &&
                         (!options->max_negative_slack_path_depth ||
@@ -773,8 +988,7 @@ RepairTimingTransform::resizeDown(Psn*                        psn_inst,
                                   std::unique_ptr<OptimizationOptions>& options)
 {
     PSN_LOG_INFO("Resize down");
-    DatabaseHandler& handler    = *(psn_inst->handler());
-    auto             clock_nets = handler.clockNets();
+    DatabaseHandler& handler = *(psn_inst->handler());
     handler.sta()->findDelays();
     float wns = handler.worstSlack();
     if (wns > 0)
@@ -785,7 +999,7 @@ RepairTimingTransform::resizeDown(Psn*                        psn_inst,
     for (auto& pin : driver_pins)
     {
         auto pin_net = handler.net(pin);
-        if (pin_net && !clock_nets.count(pin_net) &&
+        if (pin_net && !handler.isClock(pin_net) &&
             !handler.isSpecial(pin_net))
         {
             resizeDown(psn_inst, pin, options);
@@ -798,11 +1012,8 @@ void
 RepairTimingTransform::resizeDown(Psn* psn_inst, InstanceTerm* pin,
                                   std::unique_ptr<OptimizationOptions>& options)
 {
-    DatabaseHandler& handler  = *(psn_inst->handler());
-    auto             net_pins = handler.pins(handler.net(pin));
-    handler.sta()->ensureLevelized();
-    handler.sta()->vertexRequired(handler.vertex(pin), sta::MinMax::min());
-    handler.sta()->findDelays(handler.vertex(pin));
+    DatabaseHandler& handler = *(psn_inst->handler());
+    handler.updateTiming(pin);
     bool fix =
         handler.hasElectricalViolation(
             pin, options->capacitance_pessimism_factor,
@@ -821,50 +1032,60 @@ RepairTimingTransform::resizeDown(Psn* psn_inst, InstanceTerm* pin,
                 handler.equivalentCells(handler.libraryCell(inst));
             auto current_area = handler.area(replace_lib);
             auto load_cap     = handler.loadCapacitance(pin);
+            std::sort(options->buffer_lib.begin(), options->buffer_lib.end(),
+                      [&](LibraryCell* a, LibraryCell* b) -> bool {
+                          return handler.area(a) > handler.area(b);
+                      });
+            std::vector<LibraryCell*> down_types;
             for (auto& d_type : driver_types)
             {
-                auto area = handler.area(d_type);
-                std::sort(options->buffer_lib.begin(),
-                          options->buffer_lib.end(),
-                          [&](LibraryCell* a, LibraryCell* b) -> bool {
-                              return handler.area(a) > handler.area(b);
-                          });
-                if (area < current_area &&
+                if (handler.area(d_type) < current_area &&
                     handler.pinCapacitance(
                         handler.libraryInputPins(d_type).at(0)) <=
                         handler.pinCapacitance(
                             handler.libraryInputPins(init_lib).at(0)))
                 {
-                    if (handler.maxLoad(d_type) > load_cap)
-                    {
-                        handler.replaceInstance(inst, d_type);
-                        handler.sta()->ensureLevelized();
-                        handler.sta()->vertexRequired(handler.vertex(pin),
-                                                      sta::MinMax::min());
-                        handler.sta()->findDelays(handler.vertex(pin));
-                        wp            = handler.worstSlackPath(pin);
-                        float new_wns = handler.worstSlack();
-
-                        if (!wp.size() ||
-                            handler.hasElectricalViolation(
-                                pin, options->capacitance_pessimism_factor,
-                                options->transition_pessimism_factor) !=
-                                ElectircalViolation::None ||
-                            handler.worstSlack(wp[wp.size() - 1].pin()) < 0.0 ||
-                            new_wns < wns)
-                        {
-                            handler.replaceInstance(inst, replace_lib);
-                        }
-                        else
-                        {
-                            current_area = area;
-                            replace_lib  = d_type;
-                        }
-                    }
-                    else
+                    if (handler.maxLoad(d_type) <= load_cap)
                     {
                         break;
                     }
+                    down_types.push_back(d_type);
+                }
+            }
+            // Pick the smallest size estimated to keep a positive slack, it
+            // is the only one applied to the netlist
+            LibraryCell* down_type = nullptr;
+            for (auto& candidate : handler.evaluateSizes(inst, down_types))
+            {
+                if (candidate.legal && candidate.slack > 0.0 &&
+                    (!down_type || candidate.area < current_area))
+                {
+                    current_area = candidate.area;
+                    down_type    = candidate.cell;
+                }
+            }
+            if (down_type)
+            {
+                handler.checkpoint();
+                handler.replaceInstance(inst, down_type);
+                handler.updateTiming(pin);
+                wp            = handler.worstSlackPath(pin);
+                float new_wns = handler.worstSlack();
+
+                if (!wp.size() ||
+                    handler.hasElectricalViolation(
+                        pin, options->capacitance_pessimism_factor,
+                        options->transition_pessimism_factor) !=
+                        ElectircalViolation::None ||
+                    handler.worstSlack(wp[wp.size() - 1].pin()) < 0.0 ||
+                    new_wns < wns)
+                {
+                    handler.rollback();
+                }
+                else
+                {
+                    handler.commit();
+                    replace_lib = down_type;
                 }
             }
             if (replace_lib != init_lib)
@@ -1122,6 +1343,10 @@ RepairTimingTransform::repairTiming(
     PSN_LOG_INFO("Transition violations: {}", transition_violations_);
     PSN_LOG_INFO("Capacitance violations: {}", capacitance_violations_);
     PSN_LOG_INFO("Slack gain: {}", saved_slack_);
+    if (options->max_buffer_candidates)
+    {
+        PSN_LOG_INFO("Candidate limit loss: {}", approximation_loss_);
+    }
     PSN_LOG_INFO("Initial area: {}",
                  handler.unitScaledArea(options->initial_area));
     PSN_LOG_INFO("New area: {}", handler.unitScaledArea(current_area_));
@@ -1192,8 +1417,14 @@ RepairTimingTransform::run(Psn* psn_inst, std::vector<std::string> args)
          "-transition_pessimism_factor",  // Transition limit scaling factor
          "-high_effort", // Trade-off runtime versus optimization quality by
                          // weaker pruning
-         "-upstream_resistance"}); // Override default minimum upstream
-                                   // resistance
+         "-upstream_resistance", // Override default minimum upstream
+                                 // resistance
+         "-squeeze_pruning",     // Prune buffer candidates below the convex
+                                 // hull
+         "-maximum_buffer_candidates", // Maximum buffer candidates per
+                                       // Steiner point (0 for no limit)
+         "-buffering_threads"}); // Threads building the buffer candidates of
+                                 // the electrical violations concurrently
     for (size_t i = 0; i < args.size(); i++)
     {
         if (args[i].size() > 2 && args[i][0] == '-' && args[i][1] == '-')
@@ -1461,6 +1692,44 @@ RepairTimingTransform::run(Psn* psn_inst, std::vector<std::string> args)
                 custom_upstream_res                  = true;
             }
         }
+        else if (args[i] == "-maximum_buffer_candidates")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]))
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->max_buffer_candidates = atoi(args[i].c_str());
+            }
+        }
+        else if (args[i] == "-buffering_threads")
+        {
+            i++;
+            if (i >= args.size() || !StringUtils::isNumber(args[i]) ||
+                atoi(args[i].c_str()) < 1)
+            {
+                PSN_LOG_ERROR(help());
+                return -1;
+            }
+            else
+            {
+                options->buffering_threads = atoi(args[i].c_str());
+#ifndef TF_ENABLED
+                if (options->buffering_threads > 1)
+                {
+                    PSN_LOG_WARN("Built without taskflow, the buffer "
+                                 "candidates are built serially");
+                }
+#endif
+            }
+        }
+        else if (args[i] == "-squeeze_pruning")
+        {
+            options->squeeze_pruning = true;
+        }
         else if (args[i] == "-buffer_disabled")
         {
             options->disable_buffering = true;
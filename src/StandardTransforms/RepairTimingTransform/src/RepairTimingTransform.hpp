@@ -31,6 +31,7 @@
 
 #include <cstring>
 #include <memory>
+#include <set>
 #include <unordered_set>
 #include "OpenPhySyn/Database/Types.hpp"
 #include "OpenPhySyn/Liberty/LibraryMapping.hpp"
@@ -64,12 +65,45 @@ private:
                                  // violations
     float current_area_;         // Incremental area holder
     float saved_slack_;          // Total slack gain
+    float approximation_loss_;   // Worst required time lost by limiting the
+                                 // buffer candidates
+
+    BufferTreeArena buffer_tree_arena_; // Candidate trees of the current net
+
+    std::vector<InstanceTerm*> fanin_pins_; // Input pins of the current driver
 
     // Repair a single pin
     std::unordered_set<Instance*>
     repairPin(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
               std::unique_ptr<OptimizationOptions>& options);
 
+    // Pick and commit the buffer solution of a single pin
+    std::unordered_set<Instance*>
+    repairPin(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
+              std::shared_ptr<BufferSolution>       buff_sol,
+              std::unique_ptr<OptimizationOptions>& options);
+
+    // Check that the pin can be repaired and remove the existing buffers of
+    // its net if rip-up is enabled
+    bool preparePin(Psn* psn_inst, InstanceTerm* pin,
+                    std::unique_ptr<OptimizationOptions>& options);
+
+    // Build the Steiner tree of the pin net
+    std::shared_ptr<SteinerTree> pinSteinerTree(Psn*          psn_inst,
+                                                InstanceTerm* pin);
+
+    // Check if the pin net should be repaired for the target violation
+    bool isRepairCandidate(Psn* psn_inst, InstanceTerm* pin,
+                           RepairTarget                          target,
+                           std::unique_ptr<OptimizationOptions>& options);
+
+    // Repair the electrical violations by building the buffer candidates of
+    // batches of pins concurrently, the solutions are committed serially
+    int repairPinsConcurrently(Psn*                                  psn_inst,
+                               std::vector<InstanceTerm*>&           driver_pins,
+                               RepairTarget                          target,
+                               std::unique_ptr<OptimizationOptions>& options);
+
     // Number of applied design edit
     int getEditCount() const;
 
@@ -133,7 +167,8 @@ public:
         "[-high_effort] [-capacitance_pessimism_factor factor] "
         "[-transition_pessimism_factor factor] [-pins <pin names>] "
         "[-maximum_negative_slack_paths count] "
-        "[-maximum_negative_slack_path_depth count]")
+        "[-maximum_negative_slack_path_depth count] [-squeeze_pruning] "
+        "[-maximum_buffer_candidates count] [-buffering_threads count]")
 };
 
 } // namespace psn
@@ -116,7 +116,7 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
 
     auto top_point = st_tree->top();
 
-    std::shared_ptr<BufferTree>     inv_buff_tree = nullptr;
+    BufferTree*                     inv_buff_tree = nullptr;
     std::shared_ptr<BufferSolution> buff_sol      = nullptr;
 
     psn::LibraryCell* replace_driver;
@@ -128,20 +128,21 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
         auto terminals = mapping->terminals();
         buff_sol       = BufferSolution::bottomUpWithResynthesis(
             psn_inst, driver_pin, top_point, driver_point, std::move(st_tree),
-            options, terminals);
+            options, terminals, buffer_tree_arena_);
     }
     else
     {
         buff_sol =
             BufferSolution::bottomUp(psn_inst, driver_pin, top_point,
-                                     driver_point, std::move(st_tree), options);
+                                     driver_point, std::move(st_tree), options,
+                                     buffer_tree_arena_);
     }
     std::unordered_set<Instance*> added_buffers;
     std::unordered_set<Net*>      affected_nets;
     if (buff_sol->bufferTrees().size())
     {
-        std::shared_ptr<BufferTree> buff_tree    = nullptr;
-        auto                        no_buff_tree = buff_sol->bufferTrees()[0];
+        BufferTree* buff_tree    = nullptr;
+        auto        no_buff_tree = buff_sol->bufferTrees()[0];
         auto driver_lib = handler.libraryCell(driver_cell);
         if (options->driver_resize && driver_cell &&
             handler.outputPins(driver_cell).size() == 1)
@@ -237,14 +238,12 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
                                                     closest_inverse);
                             current_area_ -= handler.area(driver_lib);
                             current_area_ += handler.area(closest_inverse);
-                            std::vector<Net*> fanin_nets;
-                            for (auto& fpin : handler.inputPins(driver_cell))
+                            handler.inputPins(driver_cell, fanin_pins_);
+                            for (auto& fpin : fanin_pins_)
                             {
-                                fanin_nets.push_back(handler.net(fpin));
+                                affected_nets.insert(handler.net(fpin));
                             }
                             affected_nets.insert(handler.net(pin));
-                            affected_nets.insert(fanin_nets.begin(),
-                                                 fanin_nets.end());
 
                             buff_tree->left()->setBufferCell(left_inv);
                             buff_tree->right()->setBufferCell(right_inv);
@@ -320,6 +319,7 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
             {
                 handler.calculateParasitics(net);
             }
+            buffer_tree_arena_.reset();
             return added_buffers;
         }
         else
@@ -328,6 +328,7 @@ TimingBufferTransform::bufferPin(Psn* psn_inst, InstanceTerm* pin,
             buff_tree->logDebug();
         }
     }
+    buffer_tree_arena_.reset();
     return added_buffers;
 }
 
@@ -338,12 +339,11 @@ TimingBufferTransform::fixCapacitanceViolations(
 {
     PSN_LOG_DEBUG("Fixing capacitance violations");
     DatabaseHandler& handler           = *(psn_inst->handler());
-    auto             clock_nets        = handler.clockNets();
     int              last_buffer_count = buffer_count_;
     for (auto& pin : driver_pins)
     {
         auto pin_net = handler.net(pin);
-        if (pin_net && !clock_nets.count(pin_net))
+        if (pin_net && !handler.isClock(pin_net))
         {
             auto vio = handler.hasElectricalViolation(pin);
             if (vio == ElectircalViolation::Capacitance ||
@@ -381,13 +381,14 @@ TimingBufferTransform::fixNegativeSlack(
 {
     PSN_LOG_DEBUG("Fixing negative slack violations");
     DatabaseHandler& handler              = *(psn_inst->handler());
-    auto             negative_slack_paths = handler.getNegativeSlackPaths();
+    auto             negative_slack_paths = handler.negativeSlackPaths();
 
-    if (!negative_slack_paths.size())
+    if (!negative_slack_paths.count())
     {
         return 0;
     }
-    PSN_LOG_INFO("Found {} negative slack paths", negative_slack_paths.size());
+    PSN_LOG_INFO("Found {} negative slack paths",
+                 negative_slack_paths.count());
 
     int                               check_negative_slack_freq = 10;
     std::unordered_set<InstanceTerm*> buffered_pins;
@@ -396,14 +397,10 @@ TimingBufferTransform::fixNegativeSlack(
 
     // NOTE: This can be done in parallel..
     int unfixed_paths = 0;
-    for (size_t i = 0; i < negative_slack_paths.size(); i++)
+    while (negative_slack_paths.hasNext())
     {
-        auto& pth = negative_slack_paths[i];
-        std::reverse(pth.begin(), pth.end());
-        auto end_pin = pth[0].pin();
-        // Refresh path
-        pth                     = handler.worstSlackPath(end_pin);
-        negative_slack_paths[i] = pth;
+        auto end_pin = negative_slack_paths.nextEndpoint();
+        auto pth     = handler.worstSlackPath(end_pin);
         std::reverse(pth.begin(), pth.end());
         float worst_slack = handler.worstSlack(end_pin);
         float init_slack  = worst_slack;
@@ -474,16 +471,14 @@ TimingBufferTransform::fixTransitionViolations(
     PSN_LOG_DEBUG("Fixing transition violations");
     DatabaseHandler& handler = *(psn_inst->handler());
     handler.resetDelays();
-    auto clock_nets        = handler.clockNets();
-    int  last_buffer_count = buffer_count_;
+    int last_buffer_count = buffer_count_;
     for (auto& pin : driver_pins)
     {
         auto pin_net = handler.net(pin);
 
-        if (pin_net && !clock_nets.count(pin_net))
+        if (pin_net && !handler.isClock(pin_net))
         {
-            auto net_pins = handler.pins(pin_net);
-            auto vio      = handler.hasElectricalViolation(pin);
+            auto vio = handler.hasElectricalViolation(pin);
             if (vio == ElectircalViolation::Transition ||
                 vio == ElectircalViolation::CapacitanceAndTransition)
             {
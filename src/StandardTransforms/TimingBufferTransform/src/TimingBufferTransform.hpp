@@ -64,6 +64,10 @@ private:
     int   slack_violations_;
     float current_area_;
     float saved_slack_;
+
+    BufferTreeArena buffer_tree_arena_;
+
+    std::vector<InstanceTerm*> fanin_pins_; // Input pins of the current driver
     std::unordered_set<Instance*>
     bufferPin(Psn* psn_inst, InstanceTerm* pin, RepairTarget target,
               std::unique_ptr<OptimizationOptions>& options);
@@ -365,6 +365,7 @@ namespace eval psn {
         [-legalize_each_iteration] [-post_place] [-post_route] [-pins pin_names] [-no_resize_for_negative_slack]\
         [-legalization_frequency num_edits] [-high_effort] [-capacitance_pessimism_factor factor] [-transition_pessimism_factor factor]\
         [-upstream_resistance res] [-maximum_negative_slack_paths count] [-maximum_negative_slack_path_depth count]\
+        [-squeeze_pruning] [-maximum_buffer_candidates count] [-buffering_threads count]\
     }
     proc repair_timing { args } {
         if {![psn::has_liberty]} {
@@ -0,0 +1,76 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Liberty/ArcTable.hpp"
+#include "doctest.h"
+
+#include <vector>
+
+namespace psn
+{
+
+TEST_CASE("testing flattened arc table interpolation")
+{
+    // value = 1 + 2 * slew + 3 * cap + slew * cap is bilinear, so the
+    // interpolation and the linear extrapolation are exact
+    std::vector<float> slews = {0.0, 1.0, 4.0};
+    std::vector<float> caps  = {0.0, 2.0, 3.0, 8.0};
+    std::vector<float> values;
+    for (auto s : slews)
+    {
+        for (auto c : caps)
+        {
+            values.push_back(1 + 2 * s + 3 * c + s * c);
+        }
+    }
+    ArcTable table(slews, caps, values);
+    auto     exact = [](float s, float c) { return 1 + 2 * s + 3 * c + s * c; };
+
+    CHECK(table.findValue(1.0, 3.0) == doctest::Approx(exact(1.0, 3.0)));
+    CHECK(table.findValue(2.5, 2.5) == doctest::Approx(exact(2.5, 2.5)));
+    CHECK(table.findValue(0.5, 7.0) == doctest::Approx(exact(0.5, 7.0)));
+    CHECK(table.findValue(-1.0, 10.0) == doctest::Approx(exact(-1.0, 10.0)));
+    CHECK(table.findValue(6.0, -1.0) == doctest::Approx(exact(6.0, -1.0)));
+
+    std::vector<float> loads = {-1.0, 0.0, 1.0, 2.5, 3.0, 5.0, 9.0};
+    std::vector<float> batch(loads.size());
+    table.findValues(3.0, loads.data(), batch.data(), loads.size());
+    for (size_t i = 0; i < loads.size(); i++)
+    {
+        CHECK(batch[i] == doctest::Approx(table.findValue(3.0, loads[i])));
+    }
+
+    // Tables without a slew or a load axis
+    ArcTable load_only({0.0}, caps, {1.0, 3.0, 4.0, 9.0});
+    CHECK(load_only.findValue(5.0, 2.5) == doctest::Approx(3.5));
+    ArcTable scalar;
+    CHECK(scalar.findValue(1.0, 1.0) == 0.0);
+}
+} // namespace psn
@@ -0,0 +1,197 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Database/DatabaseHandler.hpp"
+#include "OpenPhySyn/Optimize/BufferTree.hpp"
+#include "Psn/Psn.hpp"
+#include "PsnException/PsnException.hpp"
+#include "doctest.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace psn
+{
+
+typedef std::tuple<float, float, float> Candidate; // cap, req or slew, cost
+
+// The pairwise pruning passes that the staircase sweeps replaced
+static std::vector<Candidate>
+pairwisePrune(std::vector<Candidate> candidates, DatabaseHandler* handler,
+              LibraryCell* upstream_res_cell, float minimum_upstream_res)
+{
+    std::vector<size_t> order(candidates.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto cap  = [&](size_t i) { return std::get<0>(candidates[i]); };
+    auto req  = [&](size_t i) { return std::get<1>(candidates[i]); };
+    auto cost = [&](size_t i) { return std::get<2>(candidates[i]); };
+    auto sweep = [&](std::function<bool(size_t, size_t)> keep) {
+        size_t index = 0;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            index = i + 1;
+            for (size_t j = i + 1; j < order.size(); j++)
+            {
+                if (keep(order[i], order[j]))
+                {
+                    order[index++] = order[j];
+                }
+            }
+            order.resize(index);
+        }
+    };
+    if (handler)
+    {
+        std::vector<float> buffer_req(candidates.size());
+        for (size_t i = 0; i < buffer_req.size(); i++)
+        {
+            buffer_req[i] =
+                req(i) - handler->bufferDelay(upstream_res_cell, cap(i));
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return buffer_req[a] > buffer_req[b];
+        });
+        sweep([&](size_t i, size_t j) {
+            return cap(j) < cap(i) || cost(j) < cost(i);
+        });
+        if (minimum_upstream_res)
+        {
+            std::sort(order.begin(), order.end(),
+                      [&](size_t a, size_t b) { return req(a) < req(b); });
+            sweep([&](size_t i, size_t j) {
+                return cap(i) >= cap(j) ||
+                       !((req(j) - req(i)) / (cap(j) - cap(i)) <
+                         minimum_upstream_res);
+            });
+        }
+    }
+    else
+    {
+        order.erase(std::remove_if(order.begin(), order.end(),
+                                   [&](size_t i) {
+                                       return req(i) >= minimum_upstream_res;
+                                   }),
+                    order.end());
+        std::sort(order.begin(), order.end(),
+                  [&](size_t a, size_t b) { return cost(a) < cost(b); });
+        sweep([&](size_t i, size_t j) {
+            return req(j) < req(i) || cap(j) < cap(i);
+        });
+    }
+    std::vector<Candidate> kept;
+    for (auto i : order)
+    {
+        kept.push_back(candidates[i]);
+    }
+    std::sort(kept.begin(), kept.end());
+    return kept;
+}
+
+static std::vector<Candidate>
+staircasePrune(const std::vector<Candidate>& candidates, Psn* psn_inst,
+               LibraryCell* upstream_res_cell, float minimum_upstream_res,
+               BufferMode mode)
+{
+    BufferTreeArena arena;
+    BufferSolution  solution(arena, mode);
+    for (auto& candidate : candidates)
+    {
+        solution.addTree(arena.create(std::get<0>(candidate),
+                                      std::get<1>(candidate),
+                                      std::get<2>(candidate)));
+    }
+    // Exact comparisons, as in the pairwise passes
+    solution.prune(psn_inst, upstream_res_cell, minimum_upstream_res, 0.0,
+                   0.0);
+    std::vector<Candidate> kept;
+    for (auto& tree : solution.bufferTrees())
+    {
+        kept.push_back(std::make_tuple(tree->totalCapacitance(),
+                                       tree->totalRequiredOrSlew(),
+                                       tree->cost()));
+    }
+    std::sort(kept.begin(), kept.end());
+    return kept;
+}
+
+TEST_CASE("testing buffer candidate pruning against the pairwise passes")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        auto& handler = *(psn_inst.handler());
+        handler.resetCache();
+        psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                         "NangateOpenCellLibrary_typical.lib");
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/gcd/gcd.def");
+        auto buffer_cell = handler.libraryCell("BUF_X1");
+        REQUIRE(buffer_cell != nullptr);
+
+        std::mt19937                          generator(1);
+        std::uniform_real_distribution<float> cap(1E-15, 50E-15);
+        std::uniform_real_distribution<float> req(-1E-9, 1E-9);
+        std::uniform_real_distribution<float> slew(0.0, 1E-9);
+        std::uniform_real_distribution<float> cost(0.0, 20.0);
+        for (int round = 0; round < 50; round++)
+        {
+            size_t                 count = 1 + round * 4;
+            std::vector<Candidate> timing, timerless;
+            for (size_t i = 0; i < count; i++)
+            {
+                timing.push_back(std::make_tuple(
+                    cap(generator), req(generator), cost(generator)));
+                timerless.push_back(std::make_tuple(
+                    cap(generator), slew(generator), cost(generator)));
+            }
+            float minimum_upstream_res = round % 2 ? 120.0 : 0.0;
+            CHECK(staircasePrune(timing, &psn_inst, buffer_cell,
+                                 minimum_upstream_res,
+                                 BufferMode::TimingDriven) ==
+                  pairwisePrune(timing, &handler, buffer_cell,
+                                minimum_upstream_res));
+            float max_slew = 0.8E-9;
+            CHECK(staircasePrune(timerless, &psn_inst, nullptr, max_slew,
+                                 BufferMode::Timerless) ==
+                  pairwisePrune(timerless, nullptr, nullptr, max_slew));
+        }
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+} // namespace psn
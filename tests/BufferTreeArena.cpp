@@ -0,0 +1,122 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Optimize/BufferTree.hpp"
+#include "OpenPhySyn/Liberty/LibraryMapping.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace psn
+{
+
+TEST_CASE("testing buffer tree arena allocation")
+{
+    const size_t node_count = 200000;
+    const int    rounds     = 5;
+
+    BufferTreeArena arena(1024);
+    for (int r = 0; r < rounds; r++)
+    {
+        BufferTree* prev = nullptr;
+        for (size_t i = 0; i < node_count; i++)
+        {
+            auto node = arena.create(1.0F * i, 2.0F * i, 0.0F, Point(i, i));
+            node->setLeft(prev);
+            prev = node;
+        }
+        CHECK(arena.size() == node_count);
+        CHECK(prev->left()->capacitance() == 1.0F * (node_count - 2));
+        arena.reset();
+        CHECK(arena.size() == 0);
+    }
+    // Storage is reused across resets.
+    CHECK(arena.capacity() == ((node_count + 1023) / 1024) * 1024);
+
+    // Reset releases the mappings held by the nodes.
+    auto mapping = std::make_shared<LibraryCellMappingNode>();
+    arena.create(0.0F, 0.0F, 0.0F, Point(0, 0))->setLibraryMappingNode(mapping);
+    CHECK(mapping.use_count() == 2);
+    arena.reset();
+    CHECK(mapping.use_count() == 1);
+}
+
+// Opt-in benchmark, run with --no-skip
+TEST_CASE("benchmark buffer tree arena against make_shared" * doctest::skip())
+{
+    const size_t node_count = 200000;
+    const int    rounds     = 5;
+
+    auto shared_start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        std::vector<std::shared_ptr<BufferTree>> nodes;
+        for (size_t i = 0; i < node_count; i++)
+        {
+            nodes.push_back(std::make_shared<BufferTree>(
+                1.0F * i, 2.0F * i, 0.0F, Point(i, i)));
+            if (i)
+            {
+                nodes[i]->setLeft(nodes[i - 1].get());
+            }
+        }
+    }
+    auto shared_end = std::chrono::steady_clock::now();
+
+    BufferTreeArena arena(1024);
+    auto            arena_start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        std::vector<BufferTree*> nodes;
+        for (size_t i = 0; i < node_count; i++)
+        {
+            nodes.push_back(
+                arena.create(1.0F * i, 2.0F * i, 0.0F, Point(i, i)));
+            if (i)
+            {
+                nodes[i]->setLeft(nodes[i - 1]);
+            }
+        }
+        arena.reset();
+    }
+    auto arena_end = std::chrono::steady_clock::now();
+
+    auto shared_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                           shared_end - shared_start)
+                           .count();
+    auto arena_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                          arena_end - arena_start)
+                          .count();
+    MESSAGE("make_shared: " << shared_time << "us, arena: " << arena_time
+                            << "us for " << rounds * node_count << " nodes");
+}
+} // namespace psn
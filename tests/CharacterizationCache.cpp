@@ -0,0 +1,156 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Liberty/CharacterizationCache.hpp"
+#include "doctest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace psn
+{
+
+TEST_CASE("testing characterization cache round trip")
+{
+    std::string path = "characterization_cache_test.cache";
+    std::remove(path.c_str());
+    uint64_t key = CharacterizationCache::hash("library contents");
+
+    std::vector<std::string> cells  = {"BUF_X1", "BUF_X2", "INV_X1"};
+    std::vector<float>       values = {1.5e-15, 0.0, -3.25e-12, 1e30};
+    {
+        CharacterizationCache cache;
+        CHECK(!cache.load(path, key));
+        CHECK(cache.size() == 0);
+        cache.insert("buffers", cells, values);
+        cache.insert("empty", {}, {});
+        CHECK(cache.modified());
+        CHECK(cache.save(path));
+    }
+
+    CharacterizationCache    cache;
+    std::vector<std::string> read_cells;
+    std::vector<float>       read_values;
+    REQUIRE(cache.load(path, key));
+    CHECK(!cache.modified());
+    CHECK(cache.size() == 2);
+    REQUIRE(cache.find("buffers", read_cells, read_values));
+    CHECK(read_cells == cells);
+    CHECK(read_values == values);
+    REQUIRE(cache.find("empty", read_cells, read_values));
+    CHECK(read_cells.empty());
+    CHECK(read_values.empty());
+    CHECK(!cache.find("missing", read_cells, read_values));
+
+    // New records are saved with the loaded ones
+    cache.insert("slews", {}, {2.0, 3.0});
+    cache.insert("buffers", {"BUF_X4"}, {4.0});
+    CHECK(cache.save(path));
+    CharacterizationCache updated;
+    REQUIRE(updated.load(path, key));
+    CHECK(updated.size() == 3);
+    REQUIRE(updated.find("buffers", read_cells, read_values));
+    CHECK(read_cells == std::vector<std::string>({"BUF_X4"}));
+    REQUIRE(updated.find("slews", read_cells, read_values));
+    CHECK(read_values == std::vector<float>({2.0, 3.0}));
+
+    // Another library set does not use the records
+    CharacterizationCache other;
+    CHECK(!other.load(path, key + 1));
+    CHECK(other.size() == 0);
+    CHECK(other.key() == key + 1);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("testing characterization cache corrupted files")
+{
+    std::string path = "characterization_cache_corrupted.cache";
+    uint64_t    key  = 7;
+    {
+        CharacterizationCache cache;
+        cache.reset(key);
+        cache.insert("loads", {"AND2_X1"}, {1.0, 2.0});
+        CHECK(cache.save(path));
+    }
+    std::string content;
+    {
+        std::ifstream infile(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(infile),
+                       std::istreambuf_iterator<char>());
+    }
+    // Every truncation of the file is rejected
+    for (size_t size = 0; size < content.size(); size++)
+    {
+        {
+            std::ofstream outfile(path, std::ios::binary | std::ios::trunc);
+            outfile.write(content.data(), size);
+        }
+        CharacterizationCache    cache;
+        std::vector<std::string> cells;
+        std::vector<float>       values;
+        CHECK(!cache.load(path, key));
+        CHECK(!cache.find("loads", cells, values));
+    }
+    // A different version is rejected
+    content[8] ^= 1;
+    {
+        std::ofstream outfile(path, std::ios::binary | std::ios::trunc);
+        outfile.write(content.data(), content.size());
+    }
+    CharacterizationCache cache;
+    CHECK(!cache.load(path, key));
+    std::remove(path.c_str());
+}
+
+TEST_CASE("testing characterization cache hashing")
+{
+    uint64_t first  = CharacterizationCache::hash("ab");
+    uint64_t second =
+        CharacterizationCache::hash("b", CharacterizationCache::hash("a"));
+    CHECK(first != second);
+    CHECK(CharacterizationCache::hash("ab") == first);
+
+    std::string path = "characterization_cache_hash.lib";
+    {
+        std::ofstream outfile(path, std::ios::binary | std::ios::trunc);
+        outfile << "library (test) { }";
+    }
+    uint64_t file_key = 0, same_key = 0;
+    CHECK(CharacterizationCache::hashFile(path, file_key));
+    CHECK(CharacterizationCache::hashFile(path, same_key));
+    CHECK(file_key == same_key);
+    uint64_t missing_key = 0;
+    CHECK(!CharacterizationCache::hashFile(path + ".missing", missing_key));
+    std::remove(path.c_str());
+}
+
+} // namespace psn
@@ -0,0 +1,182 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Database/DatabaseHandler.hpp"
+#include "OpenPhySyn/Sta/DatabaseSta.hpp"
+#include "Psn/Psn.hpp"
+#include "PsnException/PsnException.hpp"
+#include "doctest.h"
+#include "sta/Corner.hh"
+#include "sta/MinMax.hh"
+#include "sta/Network.hh"
+#include "sta/Parasitics.hh"
+#include "sta/Transition.hh"
+
+#include <map>
+#include <string>
+
+namespace psn
+{
+
+TEST_CASE("testing checkpoint rollback of the parasitics")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        auto& handler = *(psn_inst.handler());
+        handler.resetCache();
+        handler.resetDelays();
+        psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                         "NangateOpenCellLibrary_typical.lib");
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/gcd/gcd.def");
+        CHECK(psn_inst.database()->getChip() != nullptr);
+        handler.createClock("core_clock", {"clk"}, 10E-09);
+        psn_inst.setWireRC("metal2");
+
+        auto sta = handler.sta();
+        auto ap  = sta->corners()->findCorner(0)->findParasiticAnalysisPt(
+            sta::MinMax::max());
+        // Every estimate is scaled differently, a recomputed net can not
+        // match its previous parasitics
+        int estimate = 0;
+        handler.setComputeParasiticsCallback([&](Net* net) {
+            estimate++;
+            for (auto& pin : handler.connectedPins(net))
+            {
+                if (!handler.isDriver(pin))
+                {
+                    continue;
+                }
+                for (auto rf : sta::RiseFall::range())
+                {
+                    auto pi_elmore = sta->parasitics()->makePiElmore(
+                        pin, rf, ap, 1E-15 * estimate, 10.0 * estimate,
+                        2E-15 * estimate);
+                    for (auto& load : handler.connectedPins(net))
+                    {
+                        if (handler.isLoad(load))
+                        {
+                            sta->parasitics()->setElmore(pi_elmore, load,
+                                                         1E-12 * estimate);
+                        }
+                    }
+                }
+            }
+        });
+        handler.calculateParasitics();
+
+        // Two commutative input pins on different nets
+        InstanceTerm* first  = nullptr;
+        InstanceTerm* second = nullptr;
+        for (auto& inst : handler.instances())
+        {
+            auto in_pins = handler.inputPins(inst);
+            for (size_t i = 0; !first && i < in_pins.size(); i++)
+            {
+                for (size_t j = i + 1; j < in_pins.size(); j++)
+                {
+                    if (handler.isCommutative(in_pins[i], in_pins[j]) &&
+                        handler.net(in_pins[i]) != handler.net(in_pins[j]) &&
+                        handler.faninPin(in_pins[i]) &&
+                        handler.faninPin(in_pins[j]))
+                    {
+                        first  = in_pins[i];
+                        second = in_pins[j];
+                        break;
+                    }
+                }
+            }
+            if (first)
+            {
+                break;
+            }
+        }
+        REQUIRE(first != nullptr);
+        std::vector<InstanceTerm*> drivers = {handler.faninPin(first),
+                                              handler.faninPin(second)};
+
+        auto parasitics = [&]() -> std::map<std::string, float> {
+            handler.flushParasitics();
+            std::map<std::string, float> values;
+            for (auto& driver : drivers)
+            {
+                for (auto rf : sta::RiseFall::range())
+                {
+                    auto key = std::string(sta->network()->pathName(driver)) +
+                               rf->asString();
+                    auto pi_elmore =
+                        sta->parasitics()->findPiElmore(driver, rf, ap);
+                    if (!pi_elmore)
+                    {
+                        continue;
+                    }
+                    float c2, rpi, c1;
+                    sta->parasitics()->piModel(pi_elmore, c2, rpi, c1);
+                    values[key + "c2"]  = c2;
+                    values[key + "rpi"] = rpi;
+                    values[key + "c1"]  = c1;
+                    for (auto& load :
+                         handler.connectedPins(handler.net(driver)))
+                    {
+                        float elmore;
+                        bool  exists;
+                        sta->parasitics()->findElmore(pi_elmore, load, elmore,
+                                                      exists);
+                        if (exists)
+                        {
+                            values[key + sta->network()->pathName(load)] =
+                                elmore;
+                        }
+                    }
+                }
+            }
+            return values;
+        };
+
+        auto  before       = parasitics();
+        float slack_before = handler.worstSlack();
+        CHECK(before.size() > 0);
+        handler.checkpoint();
+        handler.swapPins(first, second);
+        CHECK(parasitics() != before);
+        handler.rollback();
+        CHECK(parasitics() == before);
+        CHECK(handler.worstSlack() == doctest::Approx(slack_before));
+        handler.setComputeParasiticsCallback(nullptr);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+} // namespace psn
@@ -0,0 +1,96 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Liberty/CompiledFunction.hpp"
+#include "doctest.h"
+
+#include <vector>
+
+namespace psn
+{
+
+TEST_CASE("testing compiled function evaluation")
+{
+    std::vector<LibraryTerm*> pins;
+    for (size_t i = 1; i <= 3; i++)
+    {
+        pins.push_back(reinterpret_cast<LibraryTerm*>(i * sizeof(void*)));
+    }
+    // (A & B) | !C
+    CompiledFunction aoi(pins);
+    aoi.pushInput(0);
+    aoi.pushInput(1);
+    aoi.pushOperation(CompiledFunction::And);
+    aoi.pushInput(2);
+    aoi.pushOperation(CompiledFunction::Not);
+    aoi.pushOperation(CompiledFunction::Or);
+    CHECK(aoi.valid());
+    CHECK(aoi.inputIndex(pins[2]) == 2);
+    CHECK(aoi.usedInputs() == 7);
+
+    std::vector<uint64_t> table;
+    REQUIRE(aoi.truthTable(table));
+    REQUIRE(table.size() == 1);
+    for (uint64_t m = 0; m < 8; m++)
+    {
+        int expected = ((m & 1) && (m & 2)) || !(m & 4);
+        CHECK(aoi.evaluate(m) == expected);
+        CHECK(int((table[0] >> m) & 1) == expected);
+    }
+    CHECK((table[0] >> 8) == 0);
+
+    // Eight input parity spans four table words
+    std::vector<LibraryTerm*> wide_pins(8, nullptr);
+    CompiledFunction          parity(wide_pins);
+    parity.pushInput(0);
+    for (int i = 1; i < 8; i++)
+    {
+        parity.pushInput(i);
+        parity.pushOperation(CompiledFunction::Xor);
+    }
+    REQUIRE(parity.truthTable(table));
+    REQUIRE(table.size() == 4);
+    for (uint64_t m = 0; m < 256; m++)
+    {
+        int expected = __builtin_popcountll(m) & 1;
+        CHECK(int((table[m >> 6] >> (m & 63)) & 1) == expected);
+    }
+
+    // Malformed code and unknown inputs are rejected
+    CompiledFunction missing_operand(pins);
+    missing_operand.pushInput(0);
+    missing_operand.pushOperation(CompiledFunction::And);
+    CHECK(!missing_operand.valid());
+    CHECK(missing_operand.evaluate(0) == -1);
+    CompiledFunction unknown_input(pins);
+    unknown_input.pushInput(5);
+    CHECK(!unknown_input.valid());
+}
+} // namespace psn
@@ -0,0 +1,189 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Database/DatabaseHandler.hpp"
+#include "OpenPhySyn/Optimize/SteinerTree.hpp"
+#include "OpenPhySyn/Sta/DatabaseSta.hpp"
+#include "Psn/Psn.hpp"
+#include "PsnException/PsnException.hpp"
+#include "doctest.h"
+#include "sta/Corner.hh"
+#include "sta/MinMax.hh"
+#include "sta/Parasitics.hh"
+#include "sta/Sdc.hh"
+#include "sta/Transition.hh"
+
+namespace psn
+{
+
+TEST_CASE("testing the pi-elmore reduction of the steiner trees")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        auto& handler = *(psn_inst.handler());
+        handler.resetCache();
+        handler.resetDelays();
+        psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                         "NangateOpenCellLibrary_typical.lib");
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/gcd/gcd.def");
+        CHECK(psn_inst.database()->getChip() != nullptr);
+        handler.createClock("core_clock", {"clk"}, 10E-09);
+        psn_inst.setWireRC("metal2");
+
+        auto sta        = handler.sta();
+        auto parasitics = sta->parasitics();
+        auto corner     = sta->corners()->findCorner(0);
+        auto ap = corner->findParasiticAnalysisPt(sta::MinMax::max());
+        auto op_cond = sta->sdc()->operatingConditions(sta::MinMax::max());
+        // Nets with and without top-level ports, the ports get an external
+        // load
+        int compared_nets      = 0;
+        int compared_port_nets = 0;
+        for (auto& net : handler.nets())
+        {
+            if (compared_nets == 10 && compared_port_nets == 10)
+            {
+                break;
+            }
+            auto driver = handler.faninPin(net);
+            auto pins   = handler.connectedPins(net);
+            if (!driver || handler.isClock(net) || pins.size() < 2 ||
+                pins.size() > 6)
+            {
+                continue;
+            }
+            bool has_port = false;
+            for (auto& pin : pins)
+            {
+                has_port = has_port || handler.isTopLevel(pin);
+            }
+            auto tree = SteinerTree::create(net, &psn_inst);
+            if ((has_port ? compared_port_nets : compared_nets) == 10 ||
+                !tree || !tree->isPlaced())
+            {
+                continue;
+            }
+            for (auto& pin : pins)
+            {
+                if (handler.isTopLevel(pin))
+                {
+                    sta->setPortExtPinCap(handler.topPort(pin),
+                                          sta::RiseFallBoth::riseFall(),
+                                          sta::MinMaxAll::all(), 5E-15);
+                }
+            }
+
+            // The pi-elmore reduced directly from the tree by the handler
+            handler.calculateParasitics(net);
+            handler.flushParasitics();
+            auto  rf = sta::RiseFall::rise();
+            float c2, rpi, c1;
+            auto  pi_elmore = parasitics->findPiElmore(driver, rf, ap);
+            REQUIRE(pi_elmore != nullptr);
+            parasitics->piModel(pi_elmore, c2, rpi, c1);
+            std::vector<float> elmore(pins.size(), 0.0);
+            for (size_t i = 0; i < pins.size(); i++)
+            {
+                bool exists;
+                parasitics->findElmore(pi_elmore, pins[i], elmore[i], exists);
+            }
+
+            // The same tree reduced by the STA from a parasitic network
+            auto node = [&](InstanceTerm* pin, SteinerPoint pt,
+                            sta::Parasitic* parasitic) {
+                if (pin == nullptr)
+                {
+                    pin = tree->alias(pt);
+                }
+                return pin ? parasitics->ensureParasiticNode(parasitic, pin)
+                           : parasitics->ensureParasiticNode(parasitic, net,
+                                                             pt);
+            };
+            auto parasitic = parasitics->makeParasiticNetwork(net, false, ap);
+            for (int i = 0; i < tree->branchCount(); i++)
+            {
+                auto branch = tree->branch(i);
+                auto n1 =
+                    node(branch.firstPin(), branch.firstSteinerPoint(),
+                         parasitic);
+                auto n2 =
+                    node(branch.secondPin(), branch.secondSteinerPoint(),
+                         parasitic);
+                if (n1 == n2)
+                {
+                    continue;
+                }
+                if (branch.wireLength() == 0)
+                {
+                    parasitics->makeResistor(nullptr, n1, n2, 1.0e-3, ap);
+                    continue;
+                }
+                float wire_length = handler.dbuToMeters(branch.wireLength());
+                float wire_cap = wire_length * handler.capacitancePerMicron();
+                float wire_res = wire_length * handler.resistancePerMicron();
+                parasitics->incrCap(n1, wire_cap / 2.0, ap);
+                parasitics->makeResistor(nullptr, n1, n2, wire_res, ap);
+                parasitics->incrCap(n2, wire_cap / 2.0, ap);
+            }
+            parasitics->reduceTo(parasitic, net,
+                                 sta::ReduceParasiticsTo::pi_elmore, op_cond,
+                                 corner, sta::MinMax::max(), ap);
+            parasitics->deleteParasiticNetwork(net, ap);
+
+            float sta_c2, sta_rpi, sta_c1;
+            auto  sta_pi_elmore = parasitics->findPiElmore(driver, rf, ap);
+            REQUIRE(sta_pi_elmore != nullptr);
+            parasitics->piModel(sta_pi_elmore, sta_c2, sta_rpi, sta_c1);
+            CHECK(c2 == doctest::Approx(sta_c2).epsilon(1E-3));
+            CHECK(rpi == doctest::Approx(sta_rpi).epsilon(1E-3));
+            CHECK(c1 == doctest::Approx(sta_c1).epsilon(1E-3));
+            for (size_t i = 0; i < pins.size(); i++)
+            {
+                float sta_elmore = 0.0;
+                bool  exists;
+                parasitics->findElmore(sta_pi_elmore, pins[i], sta_elmore,
+                                       exists);
+                CHECK(elmore[i] == doctest::Approx(sta_elmore).epsilon(1E-3));
+            }
+            (has_port ? compared_port_nets : compared_nets)++;
+        }
+        CHECK(compared_nets > 0);
+        CHECK(compared_port_nets > 0);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+} // namespace psn
@@ -0,0 +1,101 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include "OpenPhySyn/Sta/PathArena.hpp"
+#include "doctest.h"
+
+#include <vector>
+
+namespace psn
+{
+
+TEST_CASE("testing path arena storage")
+{
+    CHECK(sizeof(PathPoint) <= 24);
+
+    // Pins are only compared, fake addresses are enough
+    std::vector<int> pins(64);
+    auto             pin = [&](int i) -> InstanceTerm* {
+        return reinterpret_cast<InstanceTerm*>(&pins[i]);
+    };
+
+    PathArena paths;
+    CHECK(paths.empty());
+    for (int p = 0; p < 8; p++)
+    {
+        paths.beginPath();
+        for (int i = 0; i < p; i++)
+        {
+            paths.addPoint(PathPoint(pin(i), i % 2, 1.0F * i, 2.0F * i,
+                                     1.0F * i - 0.5F * p));
+        }
+    }
+    CHECK(paths.size() == 8);
+    CHECK(paths.pointCount() == 28);
+    CHECK(paths[0].empty());
+    CHECK(paths[7].size() == 7);
+    CHECK(paths[7].front().pin() == pin(0));
+    CHECK(paths[7].back().pin() == pin(6));
+    CHECK(paths[5][3].arrival() == 3.0F);
+    CHECK(paths[5][3].required() == 6.0F);
+    CHECK(paths[5][3].slack() == 0.5F);
+    CHECK(paths[5][3].isRise());
+    CHECK(paths[5][3].analysisPointIndex() == -1);
+
+    size_t index = 0;
+    for (auto path : paths)
+    {
+        CHECK(path.size() == index);
+        index++;
+    }
+    CHECK(index == paths.size());
+
+    auto vectors = paths.toVectors();
+    CHECK(vectors.size() == 8);
+    CHECK(vectors[6].size() == 6);
+    CHECK(vectors[6][5].pin() == pin(5));
+
+    paths.truncate(4);
+    CHECK(paths.size() == 4);
+    CHECK(paths.pointCount() == 6);
+    paths.truncate(10);
+    CHECK(paths.size() == 4);
+
+    paths.clear();
+    CHECK(paths.empty());
+    CHECK(paths.pointCount() == 0);
+    paths.addPath(vectors[3]);
+    paths.addPath(std::vector<PathPoint>());
+    CHECK(paths.size() == 2);
+    CHECK(paths[0].size() == 3);
+    CHECK(paths[1].empty());
+}
+
+} // namespace psn
@@ -33,6 +33,8 @@
 #include "Utils/FileUtils.hpp"
 #include "doctest.h"
 
+#include <tuple>
+
 using namespace psn;
 
 TEST_CASE("testing repair_timing transform")
@@ -61,3 +63,45 @@ TEST_CASE("testing repair_timing transform")
         FAIL(e.what());
     }
 }
+
+TEST_CASE("testing minimum-cost repair_timing with squeeze pruning")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        // Edit count, area and worst slack of a minimum-cost repair
+        auto repair = [&](bool squeeze_pruning) {
+            psn_inst.clearDatabase();
+            auto& handler = *(psn_inst.handler());
+            handler.resetCache();
+            handler.resetDelays();
+            psn_inst.readLib("../tests/data/libraries/Nangate45/"
+                             "NangateOpenCellLibrary_typical.lib");
+            psn_inst.readLef("../tests/data/libraries/Nangate45/"
+                             "NangateOpenCellLibrary.mod.lef");
+            psn_inst.readDef(
+                "../tests/data/designs/timing_buffer/ibex_resized.def");
+            psn_inst.setWireRC("metal2");
+            handler.createClock("core_clock", {"clk_i"}, 10E-09);
+            std::vector<std::string> args(
+                {"-buffers", "BUF_X4", "-minimum_cost_buffer_enabled",
+                 "-resize_disabled", "-pin_swap_disabled"});
+            if (squeeze_pruning)
+            {
+                args.push_back("-squeeze_pruning");
+            }
+            int result = psn_inst.runTransform("repair_timing", args);
+            return std::make_tuple(result, handler.area(),
+                                   handler.worstSlack());
+        };
+        auto full    = repair(false);
+        auto squeeze = repair(true);
+        CHECK(std::get<0>(squeeze) == std::get<0>(full));
+        CHECK(std::get<1>(squeeze) == doctest::Approx(std::get<1>(full)));
+        CHECK(std::get<2>(squeeze) == doctest::Approx(std::get<2>(full)));
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
@@ -0,0 +1,117 @@
+// BSD 3-Clause License
+
+// Copyright (c) 2019, SCALE Lab, Brown University
+// All rights reserved.
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+
+// * Redistributions of source code must retain the above copyright notice, this
+//   list of conditions and the following disclaimer.
+
+// * Redistributions in binary form must reproduce the above copyright notice,
+//   this list of conditions and the following disclaimer in the documentation
+//   and/or other materials provided with the distribution.
+
+// * Neither the name of the copyright holder nor the names of its
+//   contributors may be used to endorse or promote products derived from
+//   this software without specific prior written permission.
+
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "OpenPhySyn/Optimize/SteinerTree.hpp"
+#include "Psn/Psn.hpp"
+#include "PsnException/PsnException.hpp"
+#include "Utils/FileUtils.hpp"
+#include "doctest.h"
+
+namespace psn
+{
+
+static std::vector<int>
+flattenSteinerTree(std::unique_ptr<SteinerTree>& tree)
+{
+    std::vector<int> flat;
+    if (!tree)
+    {
+        return flat;
+    }
+    for (int i = 0; i < tree->branchCount(); i++)
+    {
+        auto branch = tree->branch(i);
+        flat.push_back(branch.firstPoint().x());
+        flat.push_back(branch.firstPoint().y());
+        flat.push_back(branch.secondPoint().x());
+        flat.push_back(branch.secondPoint().y());
+    }
+    return flat;
+}
+
+TEST_CASE("testing concurrent steiner tree construction")
+{
+    Psn& psn_inst = Psn::instance();
+    try
+    {
+        psn_inst.clearDatabase();
+        psn_inst.readLef(
+            "../tests/data/libraries/Nangate45/NangateOpenCellLibrary.mod.lef");
+        psn_inst.readDef("../tests/data/designs/aes/aes.def");
+        auto& handler = *(psn_inst.handler());
+        CHECK(psn_inst.database()->getChip() != nullptr);
+        auto nets = handler.nets();
+        CHECK(nets.size() > 0);
+
+        std::vector<std::vector<int>> serial_trees(nets.size());
+        for (size_t i = 0; i < nets.size(); i++)
+        {
+            auto tree       = SteinerTree::create(nets[i], &psn_inst);
+            serial_trees[i] = flattenSteinerTree(tree);
+        }
+
+        unsigned int thread_count =
+            std::max(4U, std::thread::hardware_concurrency());
+        std::vector<std::vector<int>> concurrent_trees(nets.size());
+        std::vector<std::thread>      threads;
+        for (unsigned int t = 0; t < thread_count; t++)
+        {
+            threads.push_back(std::thread([&, t]() {
+                for (size_t i = t; i < nets.size(); i += thread_count)
+                {
+                    auto tree = SteinerTree::create(nets[i], &psn_inst);
+                    concurrent_trees[i] = flattenSteinerTree(tree);
+                }
+            }));
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < nets.size(); i++)
+        {
+            if (serial_trees[i] != concurrent_trees[i])
+            {
+                mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+    }
+    catch (PsnException& e)
+    {
+        FAIL(e.what());
+    }
+}
+} // namespace psn